@@ -4,10 +4,20 @@
 #include <functional>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include <cstddef>
-#include <cstdlib>
+#include <cstdint>
+#include <cstdlib>            // EXIT_FAILURE, system
+#include <cstring>
+
+#include "../timing.hpp"
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#   define U8_HAS_SSE2
+#   include <emmintrin.h>       // SSE2 intrinsics.
+#endif
 
 namespace cppm {        // "C++ machinery"
     using   std::size;          // <iterator>
@@ -16,6 +26,8 @@ namespace cppm {        // "C++ machinery"
     using Byte = unsigned char;
     using C_str = const char*;
 
+    enum Process_exit_code: int { success = 0, failure = EXIT_FAILURE };
+
     struct Unchecked {};
 
     template< class T > using const_    = const T;
@@ -26,77 +38,277 @@ namespace cppm {        // "C++ machinery"
 }  // cppm
 
 namespace u8 {
-    using   cppm::Nat, cppm::Byte, cppm::C_str, cppm::Unchecked, cppm::const_, cppm::in_;
+    using   cppm::Nat, cppm::Byte, cppm::C_str, cppm::Unchecked, cppm::const_, cppm::in_, cppm::nsize;
     using   std::function,          // <functional>
             std::string,            // <string>
-            std::string_view;       // <string_view>
+            std::string_view,       // <string_view>
+            std::is_trivially_copyable_v;   // <type_traits>
+    using   std::uint32_t, std::uint64_t,   // <cstdint>
+            std::memcpy;                    // <cstring>
 
     constexpr auto is_tailbyte( const_<const char*> p_byte )
         -> bool
     { return ((Byte( *p_byte ) >> 6) == 0b10); }
 
+    // A code point is at most 4 bytes, so malformed input with a longer run of tailbytes is split
+    // into several code points. The first may then also start with a tailbyte.
     constexpr auto next_after( const_<const char*> p_first )
         -> const char*
     {
-        for( const char* p = p_first + 1; ; ++p ) { if( not is_tailbyte( p ) ) {
-            return p;
-        } }
+        const char* p = p_first + 1;
+        while( p - p_first < 4 and is_tailbyte( p ) ) { ++p; }
+        return p;
     }
 
+    // As above, but also never beyond `p_beyond`, e.g. for a view that ends mid-sequence.
+    constexpr auto next_after( const_<const char*> p_first, const_<const char*> p_beyond )
+        -> const char*
+    {
+        const char* p = p_first + 1;
+        while( p != p_beyond and p - p_first < 4 and is_tailbyte( p ) ) { ++p; }
+        return p;
+    }
+
+    // Trivially copyable, with the at most 4 bytes stored inline. The unused bytes are zero, and
+    // the byte count has the same size as the byte array, so the whole is one 64-bit value.
     class Code_point
     {
-        string  m_encoding;
+        char        m_bytes[4]  = {};
+        uint32_t    m_n_bytes   = 0;
 
     public:
         Code_point() {}
-        Code_point( const char ch ): m_encoding{ ch } {}
+        Code_point( const char ch ): m_bytes{ ch }, m_n_bytes( 1 ) {}
 
         Code_point( Unchecked, const C_str p_first_byte, const C_str p_beyond ):
-            m_encoding( p_first_byte, p_beyond )
-        {}      // assert( p_beyond == next_after( p_first_byte ) )
+            m_n_bytes( uint32_t( p_beyond - p_first_byte ) )
+        {       // assert( 0 < m_n_bytes and m_n_bytes <= 4 )
+            memcpy( m_bytes, p_first_byte, m_n_bytes );
+        }
 
         explicit Code_point( const C_str p_first_byte ):
             Code_point( Unchecked{}, p_first_byte, next_after( p_first_byte ) )
         {}
 
-        auto sv() const -> string_view { return m_encoding; }
+        auto sv() const -> string_view { return string_view( m_bytes, m_n_bytes ); }
+
+        auto bits() const
+            -> uint64_t
+        {
+            uint64_t result;
+            memcpy( &result, this, sizeof( result ) );
+            return result;
+        }
     };
 
+    static_assert( sizeof( Code_point ) == sizeof( uint64_t ) );
+    static_assert( is_trivially_copyable_v<Code_point> );
+
     inline auto operator==( in_<Code_point> a, in_<Code_point> b )
         -> bool
-    { return (a.sv() == b.sv()); }
+    { return (a.bits() == b.bits()); }
 
     inline auto operator!=( in_<Code_point> a, in_<Code_point> b )
         -> bool
-    { return (a.sv() != b.sv()); }
+    { return (a.bits() != b.bits()); }
 
     using Cp_callback = void( in_<Code_point> );
 
-    inline auto for_each_cp_in( in_<string_view> s, in_<function<Cp_callback>> callback )
+    // Inlinable: `callback` can be any callable with a signature compatible with `Cp_callback`.
+    template< class Func >
+    inline auto for_each_cp_in( in_<string_view> s, Func&& callback )
     {
         const_<const char*> p_beyond = s.data() + s.size();
         for( const char* p = s.data(); p != p_beyond; ) {
-            const_<const char*> p_next = next_after( p );
+            const_<const char*> p_next = next_after( p, p_beyond );
             callback( Code_point( Unchecked{}, p, p_next ) );   // Some premature optimization.
             p = p_next;
         }
     }
 
+    // Type erased, for ABI users. Overload resolution picks it only for a `const function` lvalue;
+    // any other argument, including a non-const `function`, is an exact match for the template.
+    inline auto for_each_cp_in( in_<string_view> s, in_<function<Cp_callback>> callback )
+    {
+        for_each_cp_in( s, [&callback]( in_<Code_point> cp ) { callback( cp ); } );
+    }
+
+    namespace impl {
+        constexpr auto popcount( uint64_t bits )
+            -> Nat
+        {
+            bits = bits - ((bits >> 1) & 0x5555'5555'5555'5555);
+            bits = (bits & 0x3333'3333'3333'3333) + ((bits >> 2) & 0x3333'3333'3333'3333);
+            bits = (bits + (bits >> 4)) & 0x0F0F'0F0F'0F0F'0F0F;
+            return Nat( (bits*0x0101'0101'0101'0101) >> 56 );
+        }
+
+        // One bit set per tailbyte, i.e. a byte of the form 0b10xx'xxxx, among the 8 bytes at `p`.
+        inline auto tailbyte_bits_of_8_at( const_<const char*> p )
+            -> uint64_t
+        {
+            uint64_t bytes;
+            memcpy( &bytes, p, sizeof( bytes ) );
+            return bytes & ~(bytes << 1) & 0x8080'8080'8080'8080;
+        }
+
+#ifdef U8_HAS_SSE2
+        // One bit set per tailbyte among the 16 bytes at `p`. As signed chars the tailbytes are
+        // exactly the values less than -0x40.
+        inline auto tailbyte_bits_of_16_at( const_<const char*> p )
+            -> uint64_t
+        {
+            const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+            return unsigned( _mm_movemask_epi8( _mm_cmplt_epi8( bytes, _mm_set1_epi8( -0x40 ) ) ) );
+        }
+#endif
+    }  // impl
+
+    // Counts the bytes that are not tailbytes, a chunk at a time.
     inline auto n_cp_in( in_<string_view> s )
         -> Nat
     {
-        Nat count = 0;
-        for_each_cp_in( s, [&count]( in_<Code_point> ){ ++count; } );
-        return count;
+        const_<const char*> p_beyond = s.data() + s.size();
+        const char* p = s.data();
+        Nat n_tailbytes = 0;
+#ifdef U8_HAS_SSE2
+        for( ; p_beyond - p >= 16; p += 16 ) { n_tailbytes += impl::popcount( impl::tailbyte_bits_of_16_at( p ) ); }
+#endif
+        for( ; p_beyond - p >= 8; p += 8 ) { n_tailbytes += impl::popcount( impl::tailbyte_bits_of_8_at( p ) ); }
+        for( ; p != p_beyond; ++p ) { n_tailbytes += is_tailbyte( p ); }
+        return nsize( s ) - n_tailbytes;
+    }
+
+    // Start of the code point with 0-based index `i` in `s`, or the end of `s` if there is none.
+    // As with `n_cp_in` a code point starts with a byte that is not a tailbyte, and whole chunks
+    // are skipped by counting those bytes.
+    inline auto p_start_of_cp( in_<string_view> s, const Nat i )
+        -> const char*
+    {
+        const_<const char*> p_beyond = s.data() + s.size();
+        const char* p = s.data();
+        Nat n_to_skip = i;
+#ifdef U8_HAS_SSE2
+        for( ; p_beyond - p >= 16; p += 16 ) {
+            const Nat n_starts = 16 - impl::popcount( impl::tailbyte_bits_of_16_at( p ) );
+            if( n_starts > n_to_skip ) { break; }
+            n_to_skip -= n_starts;
+        }
+#endif
+        for( ; p_beyond - p >= 8; p += 8 ) {
+            const Nat n_starts = 8 - impl::popcount( impl::tailbyte_bits_of_8_at( p ) );
+            if( n_starts > n_to_skip ) { break; }
+            n_to_skip -= n_starts;
+        }
+        for( ; p != p_beyond; ++p ) {
+            if( not is_tailbyte( p ) ) {
+                if( n_to_skip == 0 ) { return p; }
+                --n_to_skip;
+            }
+        }
+        return p_beyond;
+    }
+
+    // Validation. Each maximal subpart of a malformed sequence is replaced with U+FFFD, which is
+    // the practice recommended by the Unicode standard.
+    constexpr auto& replacement_char = "�";
+
+    namespace impl {
+        struct Sequence_check{ Nat n_bytes; bool is_valid; };
+
+        // Checks the sequence that starts with the non-ASCII byte at `p`. For an invalid sequence
+        // `n_bytes` is the length of its maximal subpart, which is at least 1.
+        inline auto check_sequence_at( const_<const char*> p, const_<const char*> p_beyond )
+            -> Sequence_check
+        {
+            const Byte  lead        = Byte( *p );
+            Nat         n_tails     = 0;
+            Byte        min_second  = 0x80;
+            Byte        max_second  = 0xBF;
+            if( 0xC2 <= lead and lead <= 0xDF ) {
+                n_tails = 1;
+            } else if( 0xE0 <= lead and lead <= 0xEF ) {
+                n_tails = 2;        // Below: no overlong forms, no surrogates.
+                if( lead == 0xE0 ) { min_second = 0xA0; } else if( lead == 0xED ) { max_second = 0x9F; }
+            } else if( 0xF0 <= lead and lead <= 0xF4 ) {
+                n_tails = 3;        // Below: no overlong forms, nothing beyond U+10FFFF.
+                if( lead == 0xF0 ) { min_second = 0x90; } else if( lead == 0xF4 ) { max_second = 0x8F; }
+            } else {
+                return {1, false};
+            }
+
+            for( Nat i = 1; i <= n_tails; ++i ) {
+                const Byte lo = (i == 1? min_second : 0x80);
+                const Byte hi = (i == 1? max_second : 0xBF);
+                if( p + i == p_beyond or not (lo <= Byte( p[i] ) and Byte( p[i] ) <= hi) ) {
+                    return {i, false};
+                }
+            }
+            return {n_tails + 1, true};
+        }
+
+        // The number of ASCII bytes starting at `p`, skipped a chunk at a time.
+        inline auto n_ascii_bytes_at( const_<const char*> p_first, const_<const char*> p_beyond )
+            -> Nat
+        {
+            const char* p = p_first;
+#ifdef U8_HAS_SSE2
+            for( ; p_beyond - p >= 16; p += 16 ) {
+                const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+                if( _mm_movemask_epi8( bytes ) != 0 ) { break; }
+            }
+#endif
+            for( ; p_beyond - p >= 8; p += 8 ) {
+                uint64_t bytes;
+                memcpy( &bytes, p, sizeof( bytes ) );
+                if( (bytes & 0x8080'8080'8080'8080) != 0 ) { break; }
+            }
+            while( p != p_beyond and Byte( *p ) < 0x80 ) { ++p; }
+            return Nat( p - p_first );
+        }
+    }  // impl
+
+    inline auto n_valid_bytes_at_start_of( in_<string_view> s )
+        -> Nat
+    {
+        const_<const char*> p_beyond = s.data() + s.size();
+        const char* p = s.data();
+        for( ;; ) {
+            p += impl::n_ascii_bytes_at( p, p_beyond );
+            if( p == p_beyond ) { break; }
+            const impl::Sequence_check check = impl::check_sequence_at( p, p_beyond );
+            if( not check.is_valid ) { break; }
+            p += check.n_bytes;
+        }
+        return Nat( p - s.data() );
+    }
+
+    inline auto with_invalid_replaced( in_<string_view> s )
+        -> string
+    {
+        string result;
+        result.reserve( s.size() );
+        const_<const char*> p_beyond = s.data() + s.size();
+        for( const char* p = s.data(); p != p_beyond; ) {
+            const Nat n_valid = n_valid_bytes_at_start_of( string_view( p, p_beyond - p ) );
+            result.append( p, n_valid );
+            p += n_valid;
+            if( p != p_beyond ) {
+                result += replacement_char;
+                p += impl::check_sequence_at( p, p_beyond ).n_bytes;
+            }
+        }
+        return result;
     }
 }  // u8
 
 namespace app {
-    using   cppm::Nat, cppm::C_str, cppm::in_, cppm::nsize;
+    using   cppm::Nat, cppm::Byte, cppm::C_str, cppm::Unchecked, cppm::const_, cppm::in_, cppm::nsize,
+            cppm::Process_exit_code;
 
-    using   std::max,               // <algorithm>
+    using   std::max, std::min,     // <algorithm>
             std::cout,              // <iostream>
-            std::string,            // <string>
+            std::string, std::to_string,    // <string>
             std::string_view,       // <string_view>
             std::vector;            // <vector>
 
@@ -107,37 +319,167 @@ namespace app {
 
     class Display_buffer
     {
-        using Line = vector<u8::Code_point>;
+        // A line is stored as one packed UTF-8 byte run, plus the byte offset of the start of each
+        // cell. There is one extra offset at the end, so a line of n cells has n + 1 offsets.
+        struct Line
+        {
+            string          bytes;
+            vector<Nat>     cell_starts     = {0};
+
+            // Changes since the last `append_changes_to`: a cell range, empty when first ≥ beyond,
+            // and whether the line has been cleared so that the displayed line must be erased.
+            Nat             i_first_changed     = 0;
+            Nat             i_beyond_changed    = 0;
+            bool            is_erased           = false;
+
+            auto n_cells() const -> Nat { return nsize( cell_starts ) - 1; }
+
+            void note_change_of( const Nat i_first, const Nat i_beyond )
+            {
+                if( i_first_changed >= i_beyond_changed ) {
+                    i_first_changed = i_first;  i_beyond_changed = i_beyond;
+                } else {
+                    i_first_changed = min( i_first_changed, i_first );
+                    i_beyond_changed = max( i_beyond_changed, i_beyond );
+                }
+            }
+
+            void extend_with_spaces_to( const Nat n )
+            {
+                for( Nat i = n_cells(); i < n; ++i ) {
+                    bytes += ' ';
+                    cell_starts.push_back( nsize( bytes ) );
+                }
+            }
+        };
+
         vector<Line>    m_lines;
 
+        static void append_cursor_move_to( string& output, const Nat i_row, const Nat i_col )
+        {
+            // ANSI escape sequence “CSI row ; column H”, with 1-based row and column.
+            output += "\x1B[";  output += to_string( i_row + 1 );
+            output += ';';      output += to_string( i_col + 1 );
+            output += 'H';
+        }
+
     public:
         struct Col{ Nat value; };  struct Row{ Nat value; };
 
         explicit Display_buffer( const Nat n_lines ): m_lines( n_lines ) {}
 
+        // Empties all lines but keeps their buffers, so that a reused buffer doesn’t allocate.
+        void clear()
+        {
+            for( Line& line: m_lines ) {
+                line.bytes.clear();
+                line.cell_starts.resize( 1 );
+                line.i_first_changed = line.i_beyond_changed = 0;
+                line.is_erased = true;
+            }
+        }
+
         void put_at( const Row i_row, const Col i_col, in_<string_view> line )
         {
             Line& stored = m_lines.at( i_row.value );
-            const Nat new_size = max( nsize( stored ), i_col.value + u8::n_cp_in( line ) );
-            stored.resize( new_size, ' ' );
+            // Stray tailbytes of malformed input are kept in the preceding cell, except at the start
+            // of `line` where they make up a cell of their own.
+            const bool has_stray_start  = (not line.empty() and u8::is_tailbyte( line.data() ));
+            const Nat i_first_cell      = i_col.value;
+            const Nat i_beyond_cell     = i_first_cell + u8::n_cp_in( line ) + has_stray_start;
+
+            vector<Nat>& starts = stored.cell_starts;
+            const Nat n_old_cells = stored.n_cells();
+            if( i_beyond_cell <= n_old_cells ) {
+                const Nat i_first_byte = starts[i_first_cell];
+                if( string_view( stored.bytes ).substr( i_first_byte, starts[i_beyond_cell] - i_first_byte ) == line ) {
+                    return;     // No change.
+                }
+            }
+            // Spaces that extend the line up to `i_first_cell` are not displayed, since they’re
+            // beyond the displayed line, where the terminal is blank.
+            stored.extend_with_spaces_to( i_beyond_cell );
+            stored.note_change_of( i_first_cell, i_beyond_cell );
+
+            const Nat i_first_byte  = starts[i_first_cell];
+            const Nat n_old_bytes   = starts[i_beyond_cell] - i_first_byte;
+            stored.bytes.replace( i_first_byte, n_old_bytes, line );
+
             u8::for_each_cp_in( line,
-                [i = i_col.value, &stored]( in_<u8::Code_point> cp ) mutable {
-                    stored[i++] = cp;
+                [i = i_first_cell, i_first_cell, &starts]( in_<u8::Code_point> cp ) mutable {
+                    const string_view bytes = cp.sv();
+                    if( i > i_first_cell and u8::is_tailbyte( bytes.data() ) ) {
+                        starts[i] += nsize( bytes );
+                    } else {
+                        starts[i + 1] = starts[i] + nsize( bytes );
+                        ++i;
+                    }
                 }
             );
+            const Nat byte_shift = nsize( line ) - n_old_bytes;
+            if( byte_shift != 0 ) {
+                for( Nat i = i_beyond_cell + 1; i < nsize( starts ); ++i ) { starts[i] += byte_shift; }
+            }
         }
 
         void put_at( const Row i_row, in_<string_view> line ) { put_at( i_row, Col{0}, line ); }
 
-        auto string_at( const Row i_row ) const
-            -> string
+        // For text that may be malformed UTF-8, where a malformed sequence is displayed as “�”.
+        // Valid text, the common case, is only scanned and not copied.
+        void put_validated_at( const Row i_row, const Col i_col, in_<string_view> line )
         {
-            string result;
-            for( const u8::Code_point& cp: m_lines.at( i_row.value ) ) {
-                result.append( cp.sv() );
+            if( u8::n_valid_bytes_at_start_of( line ) == nsize( line ) ) {
+                put_at( i_row, i_col, line );
+            } else {
+                put_at( i_row, i_col, u8::with_invalid_replaced( line ) );
+            }
+        }
+
+        void put_validated_at( const Row i_row, in_<string_view> line )
+        {
+            put_validated_at( i_row, Col{0}, line );
+        }
+
+        // Appends terminal output that updates the display of the previous state, or a blank
+        // display, to the current state, and then regards the current state as displayed. Row r
+        // and column c are placed at terminal position (r + 1, c + 1), which assumes that every
+        // code point occupies one terminal column.
+        void append_changes_to( string& output )
+        {
+            for( Nat i_row = 0; i_row < nsize( m_lines ); ++i_row ) {
+                Line& line = m_lines[i_row];
+                if( line.is_erased ) {
+                    append_cursor_move_to( output, i_row, 0 );
+                    output += "\x1B[K";                     // Erase to end of line.
+                }
+                if( line.i_first_changed < line.i_beyond_changed ) {
+                    const Nat i_first_byte  = line.cell_starts[line.i_first_changed];
+                    const Nat i_beyond_byte = line.cell_starts[line.i_beyond_changed];
+                    append_cursor_move_to( output, i_row, line.i_first_changed );
+                    output.append( line.bytes, i_first_byte, i_beyond_byte - i_first_byte );
+                }
+                line.i_first_changed = line.i_beyond_changed = 0;
+                line.is_erased = false;
+            }
+        }
+
+        auto string_view_at( const Row i_row ) const
+            -> string_view
+        {
+            const string_view bytes = m_lines.at( i_row.value ).bytes;
+            return bytes.substr( 0, bytes.find_last_not_of( ' ' ) + 1 );    // Trim right.
+        }
+
+        auto string_at( const Row i_row ) const -> string { return string( string_view_at( i_row ) ); }
+
+        // Appends the whole display, one '\n'-terminated line per row. With the `output` reused
+        // from frame to frame, this does not allocate.
+        void render_to( string& output ) const
+        {
+            for( Nat i = 0; i < nsize( m_lines ); ++i ) {
+                output += string_view_at( Row{ i } );
+                output += '\n';
             }
-            while( result != "" and result.back() == ' ' ) { result.pop_back(); }   // Trim right.
-            return result;
         }
     };
 
@@ -151,18 +493,16 @@ namespace app {
         return result;
     }
 
-    void run()
-    {
-        const Nat       left_margin         = 2;
-        const Nat       horizontal_scaling  = 2;    // A char is ~half as wide as high.
-
-        const int   i_first_line    = -15;
-        const int   i_last_line     = +15;
-        const Nat   n_columns       = 120;
-        const Nat   n_lines         = (i_last_line + 1) - i_first_line;
+    const Nat   left_margin     = 2;
+    const int   i_first_line    = -15;
+    const int   i_last_line     = +15;
+    const Nat   n_columns       = 120;
+    const Nat   n_lines         = (i_last_line + 1) - i_first_line;
 
+    // A char is ~half as wide as high, so a `horizontal_scaling` of 2 gives the graph’s proportions.
+    void put_graph_in( Display_buffer& display_buffer, const Nat horizontal_scaling )
+    {
         using Row = Display_buffer::Row;  using Col = Display_buffer::Col;
-        auto display_buffer = Display_buffer( n_lines );
 
         const auto generate_y_axis = [&]
         {
@@ -197,8 +537,383 @@ namespace app {
             Row{ 2 - i_first_line }, Col{ left_margin + 40 },
             "Parabola (x²/4) — ASCII art graph by 日本国 кошка, version 2."
             );
-        for( Nat i = 0; i < n_lines; ++i ) { cout << display_buffer.string_at( Row{ i } ) << '\n'; }
+    }
+
+    void run()
+    {
+        auto display_buffer = Display_buffer( n_lines );
+        put_graph_in( display_buffer, 2 );
+        string frame;
+        display_buffer.render_to( frame );
+        cout.write( frame.data(), frame.size() );       // One write of the whole frame.
+    }
+
+    namespace checks {
+        using   std::function;              // <functional>
+        using   timing::seconds_per_call_of;  // "../timing.hpp"
+
+        // Exhaustive over what the chunked `u8::n_cp_in` and `u8::p_start_of_cp` depend on: each
+        // byte value at each position of each length up to two 16-byte chunks, an 8-byte chunk and
+        // a partial one, on backgrounds of the bytes at the tailbyte range boundaries, and each
+        // tailbyte pattern of up to 20 bytes. They must agree with a plain byte at a time scan.
+        auto check_code_point_counting()
+            -> bool
+        {
+            Nat n_strings = 0;
+            Nat n_wrong = 0;
+            vector<const char*> starts;
+            const auto check = [&]( in_<string_view> s )
+            {
+                starts.clear();
+                for( const char& ch: s ) { if( not u8::is_tailbyte( &ch ) ) { starts.push_back( &ch ); } }
+                starts.push_back( s.data() + s.size() );    // For the index beyond the last.
+
+                ++n_strings;
+                bool is_right = (u8::n_cp_in( s ) == nsize( starts ) - 1);
+                for( Nat i = 0; i < nsize( starts ); ++i ) {
+                    is_right = is_right and (u8::p_start_of_cp( s, i ) == starts[i]);
+                }
+                n_wrong += not is_right;
+            };
+
+            const Nat max_length = 16*2 + 8 + 7;
+            for( Nat n = 0; n <= max_length; ++n ) {
+                for( const Byte background: {0x00, 0x7F, 0x80, 0xBF, 0xC0, 0xFF} ) {
+                    string s( n, char( background ) );
+                    for( Nat i = 0; i < n; ++i ) {
+                        for( Nat value = 0; value < 256; ++value ) {
+                            s[i] = char( value );
+                            check( s );
+                        }
+                        s[i] = char( background );
+                    }
+                }
+            }
+            for( Nat n = 0; n <= 20; ++n ) {
+                string s( n, 'a' );
+                for( Nat pattern = 0; pattern < (1 << n); ++pattern ) {
+                    for( Nat i = 0; i < n; ++i ) { s[i] = ((pattern >> i) & 1? '\x80' : 'a'); }
+                    check( s );
+                }
+            }
+
+            const bool ok = (n_wrong == 0);
+            cout << "Counting code points and finding their starts: " << n_strings << " strings, "
+                 << (ok? "all equal to a byte at a time scan." : "SOME DIFFER FROM A BYTE AT A TIME SCAN.") << "\n";
+            return ok;
+        }
+
+        // Malformed sequences and the number of U+FFFD that replace them, one per maximal subpart,
+        // as in the examples of the Unicode standard, and valid sequences at the range boundaries.
+        // Each is checked as is and after an ASCII prefix long enough for the chunked skipping.
+        auto check_validation()
+            -> bool
+        {
+            struct Case{ string_view bytes; Nat n_replacements; };
+            static const Case cases[] =
+            {
+                {"\xC0\xAF", 2}, {"\xC1\xBF", 2},                        // Overlong, 2 bytes.
+                {"\xE0\x80\xAF", 3}, {"\xE0\x9F\xBF", 3},                // Overlong, 3 bytes.
+                {"\xF0\x80\x80\xAF", 4}, {"\xF0\x8F\xBF\xBF", 4},        // Overlong, 4 bytes.
+                {"\xED\xA0\x80", 3}, {"\xED\xBF\xBF", 3},                // Surrogates.
+                {"\xF4\x90\x80\x80", 4}, {"\xF5\x80\x80\x80", 4},        // Beyond U+10FFFF.
+                {"\xF8\x88\x80\x80\x80", 5}, {"\xFF", 1},
+                {"\xC3", 1}, {"\xE2\x82", 1}, {"\xF0\x9F\x98", 1},        // Truncated at the end.
+                {"\xE2\x82z", 1}, {"\xF0\x9F\x98\xC3\xA6", 1},            // Truncated before more.
+                {"\x80", 1}, {"\x80\xBF", 2}, {"\xC3\xA6\x80", 1},         // Stray tailbytes.
+                {"a\xF1\x80\x80\xE1\x80\xC2" "b\x80" "c\x80\xBF" "d", 6},   // Mixed, from the standard.
+                {"\xC2\x80", 0}, {"\xDF\xBF", 0}, {"\xE0\xA0\x80", 0},     // Valid, at the boundaries.
+                {"\xED\x9F\xBF", 0}, {"\xEE\x80\x80", 0}, {"\xF0\x90\x80\x80", 0},
+                {"\xF4\x8F\xBF\xBF", 0}, {"кошка 日本国", 0},
+            };
+
+            const string ascii_prefix( 16 + 8 + 5, 'a' );
+            Nat n_checks = 0;
+            Nat n_wrong = 0;
+            for( in_<Case> c: cases ) {
+                for( in_<string> prefix: {string(), ascii_prefix} ) {
+                    const string input = prefix + string( c.bytes );
+                    const string result = u8::with_invalid_replaced( input );
+
+                    Nat n_replacements = 0;
+                    for( size_t i = 0; (i = result.find( u8::replacement_char, i )) != string::npos; ++i ) {
+                        ++n_replacements;
+                    }
+                    // The valid start is kept as is, up to the first replacement.
+                    const size_t n_valid = min( result.find( u8::replacement_char ), input.size() );
+                    ++n_checks;
+                    n_wrong += not (
+                        n_replacements == c.n_replacements
+                        and size_t( u8::n_valid_bytes_at_start_of( input ) ) == n_valid
+                        and result.compare( 0, n_valid, input, 0, n_valid ) == 0
+                        and (n_replacements > 0 or result == input)
+                        );
+                }
+            }
+
+            const bool ok = (n_wrong == 0);
+            cout << "Validation: " << n_checks << " cases, "
+                 << (ok? "all with the expected replacements." : "SOME WITH OTHER REPLACEMENTS.") << "\n";
+            return ok;
+        }
+
+        // A terminal as assumed by `Display_buffer::append_changes_to`: one code point per column,
+        // and of escape sequences only cursor positioning and erasing to the end of the line.
+        class Terminal_model
+        {
+            vector<vector<u8::Code_point>>  m_lines;
+            Nat                             m_i_row     = 0;
+            Nat                             m_i_col     = 0;
+
+            static auto parsed_number( const char*& p, const char* const p_beyond )
+                -> Nat
+            {
+                Nat result = 0;
+                for( ; p != p_beyond and '0' <= *p and *p <= '9'; ++p ) { result = 10*result + (*p - '0'); }
+                return result;
+            }
+
+        public:
+            explicit Terminal_model( const Nat n_lines ): m_lines( n_lines ) {}
+
+            // Returns false for output that this model doesn’t handle.
+            auto replay( in_<string_view> output )
+                -> bool
+            {
+                const_<const char*> p_beyond = output.data() + output.size();
+                for( const char* p = output.data(); p != p_beyond; ) {
+                    if( *p == '\x1B' ) {
+                        if( ++p == p_beyond or *p != '[' ) { return false; }
+                        ++p;
+                        if( p != p_beyond and *p == 'K' ) {
+                            ++p;
+                            vector<u8::Code_point>& line = m_lines[m_i_row];
+                            line.resize( min( nsize( line ), m_i_col ) );
+                        } else {
+                            const Nat row = parsed_number( p, p_beyond );
+                            if( p == p_beyond or *p != ';' ) { return false; }
+                            ++p;
+                            const Nat col = parsed_number( p, p_beyond );
+                            if( p == p_beyond or *p != 'H' ) { return false; }
+                            ++p;
+                            if( not (1 <= row and row <= nsize( m_lines ) and 1 <= col) ) { return false; }
+                            m_i_row = row - 1;  m_i_col = col - 1;
+                        }
+                    } else {
+                        const_<const char*> p_next = u8::next_after( p, p_beyond );
+                        vector<u8::Code_point>& line = m_lines[m_i_row];
+                        if( m_i_col >= nsize( line ) ) { line.resize( m_i_col + 1, u8::Code_point( ' ' ) ); }
+                        line[m_i_col] = u8::Code_point( Unchecked{}, p, p_next );
+                        ++m_i_col;
+                        p = p_next;
+                    }
+                }
+                return true;
+            }
+
+            // As `Display_buffer::render_to`.
+            void render_to( string& output ) const
+            {
+                for( in_<vector<u8::Code_point>> line: m_lines ) {
+                    Nat n = nsize( line );
+                    while( n > 0 and line[n - 1] == u8::Code_point( ' ' ) ) { --n; }
+                    for( Nat i = 0; i < n; ++i ) { output += line[i].sv(); }
+                    output += '\n';
+                }
+            }
+        };
+
+        // Replays the incremental output of a sequence of updates, and compares the replayed
+        // display with the rendered one after each update.
+        auto check_incremental_output()
+            -> bool
+        {
+            using Row = Display_buffer::Row;  using Col = Display_buffer::Col;
+
+            auto display_buffer = Display_buffer( n_lines );
+            auto terminal       = Terminal_model( n_lines );
+            string output;
+            string expected;
+            string replayed;
+            Nat n_updates   = 0;
+            Nat n_wrong     = 0;
+            const auto check_update = [&]() -> Nat
+            {
+                output.clear();
+                display_buffer.append_changes_to( output );
+                const bool is_handled = terminal.replay( output );
+                expected.clear();  display_buffer.render_to( expected );
+                replayed.clear();  terminal.render_to( replayed );
+                ++n_updates;
+                n_wrong += (not is_handled or replayed != expected);
+                return nsize( output );
+            };
+
+            put_graph_in( display_buffer, 2 );
+            const Nat n_full_bytes = check_update();
+            check_update();         // No change.
+            display_buffer.put_at( Row{ 5 }, Col{ 30 }, "■" );
+            const Nat n_cell_bytes = check_update();
+            display_buffer.put_at( Row{ 5 }, Col{ 30 }, "кошка" );
+            display_buffer.put_at( Row{ 5 }, Col{ 10 }, "日本国" );
+            display_buffer.put_at( Row{ 30 }, Col{ 150 }, "beyond the graph" );
+            check_update();
+            display_buffer.put_validated_at( Row{ 7 }, Col{ 3 }, "a\xE2\x80\x80\x80z\xF0" );
+            check_update();
+            display_buffer.put_at( Row{ 9 }, Col{ 130 }, "  " );     // Spaces beyond the end of the line.
+            const Nat n_extension_bytes = check_update();
+            for( Nat scaling = 1; scaling <= 4; ++scaling ) {
+                display_buffer.clear();
+                put_graph_in( display_buffer, scaling );
+                check_update();
+                display_buffer.clear();     // Only erasing.
+                check_update();
+                put_graph_in( display_buffer, scaling );
+                check_update();
+            }
+
+            const bool is_extension_output = (n_extension_bytes > 0);
+            cout << "Incremental output: " << n_updates << " updates replayed, "
+                 << (n_wrong == 0? "all equal to the rendered display" : "SOME DIFFER FROM THE RENDERED DISPLAY")
+                 << ". Putting one cell output " << n_cell_bytes << " bytes, the whole graph "
+                 << n_full_bytes << (is_extension_output? "." : ", BUT EXTENDING A LINE OUTPUT NOTHING.") << "\n";
+            return (n_wrong == 0 and is_extension_output);
+        }
+
+        // A frame drawn into a `clear`-ed buffer reuses its line buffers, while a frame drawn into a
+        // new buffer allocates each line anew.
+        auto report_on_buffer_reuse()
+            -> bool
+        {
+            string frame;
+            auto reused_buffer = Display_buffer( n_lines );
+            const double reused_time = seconds_per_call_of( [&]{
+                reused_buffer.clear();
+                put_graph_in( reused_buffer, 2 );
+                frame.clear();  reused_buffer.render_to( frame );
+            } );
+            const string reused_frame = frame;
+            const double new_time = seconds_per_call_of( [&]{
+                auto new_buffer = Display_buffer( n_lines );
+                put_graph_in( new_buffer, 2 );
+                frame.clear();  new_buffer.render_to( frame );
+            } );
+
+            const bool ok = (frame == reused_frame);
+            cout << "Drawing the graph: " << 1e6*reused_time << " μs per frame in a cleared buffer, "
+                 << 1e6*new_time << " μs in a new buffer" << (ok? "." : ", BUT THE FRAMES DIFFER.") << "\n";
+            return ok;
+        }
+
+        // Mixed ASCII, CJK and Cyrillic text like the graph’s title, with 20 code points per `n`.
+        auto sample_text( const Nat n, const bool uppercase = false )
+            -> string
+        { return repeat_times( n, (uppercase? " GRAPH BY 日本国 кошка," : " graph by 日本国 кошка,") ); }
+
+        // Cells per second for overwriting a line with `put_at`, and for the code point values
+        // alone: storing them in a line of inline `u8::Code_point` cells, versus a line of cells
+        // that hold their bytes in a `std::string`, which is how `Code_point` was represented.
+        auto report_on_put_at()
+            -> bool
+        {
+            struct String_code_point{ string bytes; };
+
+            const string texts[] = {sample_text( 5 ), sample_text( 5, true )};     // Different, same size.
+            const Nat n_cells = u8::n_cp_in( texts[0] );
+
+            auto display_buffer = Display_buffer( 1 );
+            const double put_time = seconds_per_call_of( [&]{
+                for( in_<string> text: texts ) { display_buffer.put_at( Display_buffer::Row{ 0 }, text ); }
+            } );
+
+            vector<u8::Code_point> cells( n_cells );
+            const double inline_time = seconds_per_call_of( [&]{
+                for( in_<string> text: texts ) {
+                    u8::for_each_cp_in( text, [&, i = 0]( in_<u8::Code_point> cp ) mutable { cells[i++] = cp; } );
+                }
+            } );
+
+            vector<String_code_point> string_cells( n_cells );
+            const double string_time = seconds_per_call_of( [&]{
+                for( in_<string> text: texts ) {
+                    u8::for_each_cp_in( text, [&, i = 0]( in_<u8::Code_point> cp ) mutable {
+                        string_cells[i++] = String_code_point{ string( cp.sv() ) };
+                    } );
+                }
+            } );
+
+            string inline_line;  string string_line;
+            for( const u8::Code_point cp: cells ) { inline_line += cp.sv(); }
+            for( in_<String_code_point> cp: string_cells ) { string_line += cp.bytes; }
+            const bool ok = (display_buffer.string_at( Display_buffer::Row{ 0 } ) == texts[1]
+                and inline_line == texts[1] and string_line == texts[1]);
+
+            const double n_cells_per_call = 2.0*n_cells;
+            cout << "Putting a line of " << n_cells << " cells: " << 1e-6*n_cells_per_call/put_time
+                 << " Mcells/s with `put_at`; storing the code points as cells "
+                 << 1e-6*n_cells_per_call/inline_time << " Mcells/s inline, "
+                 << 1e-6*n_cells_per_call/string_time << " Mcells/s in `std::string`s"
+                 << (ok? "." : ", BUT THE LINES DIFFER.") << "\n";
+            return ok;
+        }
+
+        // Code points per second for `u8::for_each_cp_in` over a few MB of mixed text, with the
+        // callback inlined via the template overload, and called via the `std::function` overload.
+        auto report_on_for_each_cp()
+            -> bool
+        {
+            const string text = sample_text( 150'000 );
+            const Nat n_cps = u8::n_cp_in( text );
+
+            Nat n_inlined_bytes = 0;
+            const double inlined_time = seconds_per_call_of( [&]{
+                n_inlined_bytes = 0;
+                u8::for_each_cp_in( text, [&]( in_<u8::Code_point> cp ) { n_inlined_bytes += nsize( cp.sv() ); } );
+            } );
+
+            Nat n_erased_bytes = 0;
+            const function<u8::Cp_callback> callback = [&]( in_<u8::Code_point> cp ) {
+                n_erased_bytes += nsize( cp.sv() );
+            };
+            const double erased_time = seconds_per_call_of( [&]{
+                n_erased_bytes = 0;
+                u8::for_each_cp_in( text, callback );       // A `const function` lvalue: not the template.
+            } );
+
+            const bool ok = (n_inlined_bytes == nsize( text ) and n_erased_bytes == nsize( text ));
+            cout << "Iterating over " << n_cps << " code points in " << 1e-6*nsize( text ) << " MB: "
+                 << 1e-6*n_cps/inlined_time << " Mcp/s inlined, " << 1e-6*n_cps/erased_time
+                 << " Mcp/s via `std::function`" << (ok? "." : ", BUT NOT ALL BYTES WERE VISITED.") << "\n";
+            return ok;
+        }
+
+        auto all_ok()
+            -> bool
+        {
+            bool ok = true;
+            ok = check_code_point_counting() and ok;
+            ok = check_validation() and ok;
+            ok = check_incremental_output() and ok;
+            ok = report_on_buffer_reuse() and ok;
+            ok = report_on_put_at() and ok;
+            ok = report_on_for_each_cp() and ok;
+            return ok;
+        }
+    }  // checks
+
+    // With `--check` runs the self-checks instead of displaying the graph.
+    auto run( in_<vector<string>> args )
+        -> Process_exit_code
+    {
+        if( args == vector<string>{ "--check" } ) {
+            return (checks::all_ok()? Process_exit_code::success : Process_exit_code::failure);
+        }
+    #ifdef _WIN32
+        system( "chcp 65001 >nul" );    // UTF-8 console output; `nul` is a device in Windows only.
+    #endif
+        run();
+        return Process_exit_code::success;
     }
 }  // app
 
-auto main() -> int { system( "chcp 65001 >nul" );  app::run(); }
+auto main( const int n_args, char** const args ) -> int { return app::run( {args + 1, args + n_args} ); }
@@ -0,0 +1,1281 @@
+﻿// Measurements and checks of the painting code of “parabola-gdi.v6.cpp”, run headless with
+// the painting into an in-memory framebuffer, e.g. in Linux. Each report prints its numbers, and
+// the exit code is failure if a check fails, i.e. if a report says “BUT …”.
+#ifdef _WIN32
+#   error "This is a headless program: please build it without `_WIN32`, e.g. in Linux."
+#   include <terminate-compilation>     // Workaround for “must continue anyway!” g++.
+#endif
+
+#include "parabola-gdi.v6.cpp"
+#include "timing.hpp"
+
+#include <fcntl.h>          // open, posix_fadvise
+#include <sys/mman.h>       // mincore
+#include <unistd.h>         // close, fsync, sysconf
+
+namespace app {
+    namespace checks {
+        namespace chrono = std::chrono;
+        namespace fs = std::filesystem;
+        using   timing::seconds_for, timing::seconds_per_call_of;
+        using   graphics::rgba, graphics::Rgba_framebuffer, graphics::Framebuffer_surface,
+                graphics::Display_list, graphics::Tiled_framebuffer, graphics::rasterize_in_parallel,
+                graphics::Retained_frame_, graphics::Framebuffer_backbuffer;
+
+        using   std::max,               // <algorithm>
+                std::thread;            // <thread>
+
+        using   std::uint32_t;          // <cstdint>
+
+        const SIZE  default_size    = {624, 361};       // Client area of the GUI version’s window.
+        const auto  orange          = rgba( 0xFF, 0x80, 0x00 );
+
+        // Like a `WM_SIZE` (when the size changes) followed by a `WM_PAINT` for the invalidated area.
+        struct Update{ SIZE size; RECT invalidated; };
+
+        // Dragging the right edge out and back, then the same for the bottom edge.
+        auto resize_sequence()
+            -> vector<Update>
+        {
+            vector<Update> result;
+            const auto& d = default_size;
+            for( Nat w = d.cx; w <= d.cx + 400; w += 8 )    { result.push_back( {{w, d.cy}, {}} ); }
+            for( Nat w = d.cx + 400; w >= d.cx; w -= 8 )    { result.push_back( {{w, d.cy}, {}} ); }
+            for( Nat h = d.cy; h <= d.cy + 200; h += 8 )    { result.push_back( {{d.cx, h}, {}} ); }
+            for( Nat h = d.cy + 200; h >= d.cy; h -= 8 )    { result.push_back( {{d.cx, h}, {}} ); }
+            return result;
+        }
+
+        // A 100×100 window being dragged across, continuously exposing what it covered.
+        auto expose_sequence()
+            -> vector<Update>
+        {
+            vector<Update> result;
+            for( Nat x = 0; x + 100 <= default_size.cx; x += 8 ) {
+                result.push_back( {default_size, {x, 100, x + 100, 200}} );
+            }
+            return result;
+        }
+
+        // A frame painted by the painter, to compare with.
+        auto painted_frame( in_<SIZE> size )
+            -> Rgba_framebuffer
+        {
+            auto result = Rgba_framebuffer( size, orange );
+            auto surface = Framebuffer_surface( result );
+            Painter( surface, size ).paint();
+            return result;
+        }
+
+        // The times of drawing something in two ways, A and B, and whether the pixels are the same.
+        struct Drawings_comparison{ double a_time; double b_time; bool is_same; };
+
+        // Calls `draw_a` and `draw_b` with a framebuffer each of the given size, compares the
+        // pixels, and then times repeated calls of each.
+        template< class Draw_a, class Draw_b >
+        auto compared_drawings( in_<SIZE> size, in_<Draw_a> draw_a, in_<Draw_b> draw_b )
+            -> Drawings_comparison
+        {
+            auto a_image = Rgba_framebuffer( size, orange );
+            auto b_image = Rgba_framebuffer( size, orange );
+            draw_a( a_image );  draw_b( b_image );
+            const bool is_same = (a_image == b_image);
+            return {
+                seconds_per_call_of( [&]{ draw_a( a_image ); } ),
+                seconds_per_call_of( [&]{ draw_b( b_image ); } ),
+                is_same
+                };
+        }
+
+        auto full_repaints( in_<vector<Update>> updates )
+            -> Rgba_framebuffer
+        {
+            auto framebuffer = Rgba_framebuffer( default_size, orange );
+            for( const Update& update: updates ) {
+                if( update.size.cx != framebuffer.w() or update.size.cy != framebuffer.h() ) {
+                    framebuffer = Rgba_framebuffer( update.size, orange );
+                } else {
+                    framebuffer.fill( orange );
+                }
+                auto surface = Framebuffer_surface( framebuffer );
+                Painter( surface, update.size ).paint();
+            }
+            return framebuffer;
+        }
+
+        auto tiled_repaints( in_<vector<Update>> updates, Nat& n_tiles_rasterized )
+            -> Rgba_framebuffer
+        {
+            auto tiled_framebuffer = Tiled_framebuffer( default_size, orange );
+            auto display_list = Display_list();
+            display_list.clear();
+            Painter( display_list, default_size ).paint();
+            tiled_framebuffer.update_from( display_list );      // The initial frame.
+
+            n_tiles_rasterized = 0;
+            for( const Update& update: updates ) {
+                const Rgba_framebuffer& pixels = tiled_framebuffer.pixels();
+                if( update.size.cx != pixels.w() or update.size.cy != pixels.h() ) {
+                    tiled_framebuffer.resize( update.size );
+                }
+                tiled_framebuffer.invalidate( update.invalidated );
+                display_list.clear();
+                Painter( display_list, update.size ).paint();
+                n_tiles_rasterized += tiled_framebuffer.update_from( display_list );
+            }
+            return tiled_framebuffer.pixels();
+        }
+
+        // The window’s pixels, painted via a retained frame. A change of size invalidates all.
+        auto retained_repaints( in_<vector<Update>> updates, Nat& n_renders )
+            -> Rgba_framebuffer
+        {
+            auto window = Rgba_framebuffer( default_size, orange );
+            auto frame = Retained_frame_<Framebuffer_backbuffer>( orange );
+            const auto render = []( graphics::Surface& surface, in_<SIZE> size ) { Painter( surface, size ).paint(); };
+            frame.paint( window, default_size, window.bounds(), render );     // The initial frame.
+
+            for( const Update& update: updates ) {
+                RECT update_rect = update.invalidated;
+                if( update.size.cx != window.w() or update.size.cy != window.h() ) {
+                    window = Rgba_framebuffer( update.size, orange );
+                    update_rect = window.bounds();
+                }
+                frame.paint( window, update.size, update_rect, render );
+            }
+            n_renders = frame.n_renders();
+            return window;
+        }
+
+        auto report_on( const C_str name, in_<vector<Update>> updates )
+            -> bool
+        {
+            Nat n_tiles = 0;
+            Nat n_renders = 0;
+            const Rgba_framebuffer full = full_repaints( updates );
+            const bool is_same = (
+                full == tiled_repaints( updates, n_tiles ) and full == retained_repaints( updates, n_renders )
+                );
+            const double full_time = seconds_per_call_of( [&]{ full_repaints( updates ); } );
+            const double tiled_time = seconds_per_call_of( [&]{ tiled_repaints( updates, n_tiles ); } );
+            const double retained_time = seconds_per_call_of( [&]{ retained_repaints( updates, n_renders ); } );
+
+            const Nat n = Nat( updates.size() );
+            cout << name << ", " << n << " updates: "
+                 << 1e6*full_time/n << " µs per full repaint, "
+                 << 1e6*tiled_time/n << " µs per tile-incremental repaint with "
+                 << 1.0*n_tiles/n << " tiles of " << Tiled_framebuffer::tile_size << "×"
+                 << Tiled_framebuffer::tile_size << " on average, "
+                 << 1e6*retained_time/n << " µs per repaint from a retained frame with "
+                 << n_renders << " renders"
+                 << (is_same? "." : ", BUT THE RESULTS DIFFER.") << "\n";
+            return is_same;
+        }
+
+        // An 8K export painted directly, then as tiles on 1, 2, 4, … threads.
+        auto report_on_parallel_export()
+            -> bool
+        {
+            const SIZE size = {7680, 4320};
+            auto direct = Rgba_framebuffer( size, orange );
+            auto direct_surface = Framebuffer_surface( direct );
+            const double direct_time = seconds_per_call_of( [&]{
+                direct.fill( orange );
+                Painter( direct_surface, size ).paint();
+            } );
+            cout << "Exporting " << size.cx << "×" << size.cy << ": "
+                 << 1e3*direct_time << " ms painted directly.\n";
+
+            auto display_list = Display_list();
+            Painter( display_list, size ).paint();
+            auto tiled = Rgba_framebuffer( size, orange );
+            const Nat n_max_threads = max<Nat>( 4, thread::hardware_concurrency() );
+            double time_for_1 = 0;
+            bool is_same = true;
+            for( Nat n_threads = 1; n_threads <= n_max_threads; n_threads *= 2 ) {
+                const double time = seconds_per_call_of( [&]{
+                    rasterize_in_parallel( display_list, tiled, orange, n_threads );
+                } );
+                if( n_threads == 1 ) { time_for_1 = time; }
+                is_same = is_same and (tiled == direct);
+                cout << "    " << n_threads << " thread(s): " << 1e3*time << " ms, speedup "
+                     << time_for_1/time << (tiled == direct? "." : ", BUT THE RESULT DIFFERS.") << "\n";
+            }
+            return is_same;
+        }
+
+        // Discards everything, so that only the sampling is measured.
+        struct Null_surface: graphics::Surface
+        {
+            void polyline( const POINT*, Nat ) override {}
+            void fill_rect( in_<RECT> ) override {}
+        };
+
+        template< class Func >
+        void report_on_plotting( const C_str name, in_<Func> f )
+        {
+            const SIZE size = {624, 100'000};       // x is vertical, so 100 002 samples.
+            const auto transform = coordinate::Axis_relative_transform( size );
+            const auto inlined = Function_plotter_<Func>( f );
+            const auto indirect = Function_plotter_<Runtime_function>( f );
+            const Function_plotter& p_inlined = inlined;
+            const Function_plotter& p_indirect = indirect;
+
+            auto surface = Null_surface();
+            const double n_samples = size.cy + 2;
+            const double inlined_time = seconds_per_call_of( [&]{ p_inlined.plot( surface, transform ); } );
+            const double indirect_time = seconds_per_call_of( [&]{ p_indirect.plot( surface, transform ); } );
+            cout << "    " << name << ": " << 1e9*inlined_time/n_samples << " ns inlined, "
+                 << 1e9*indirect_time/n_samples << " ns via `std::function`.\n";
+        }
+
+        // Plotting with the function inlined versus called via `std::function`.
+        void report_on_function_plotters()
+        {
+            cout << "Time per plotted sample:\n";
+            report_on_plotting( "x²/4", Parabola() );
+            report_on_plotting( "Degree 7 polynomial", []( const double x ) -> double {
+                return ((((((x/8 - 1)*x/7 + 1)*x/6 - 1)*x/5 + 1)*x/4 - 1)*x/3 + 1)*x/2 - 1;
+            } );
+            report_on_plotting( "sin(x)·exp(-x²/1000)", []( const double x ) -> double {
+                return std::sin( x )*std::exp( -x*x/1000 );
+            } );
+        }
+
+        // Keeps the points of all polylines, in order, and the number of points in each, since a
+        // clipped plot can be several polylines.
+        struct Polyline_recorder: graphics::Surface
+        {
+            vector<POINT>   points;
+            vector<Nat>     counts;
+
+            void polyline( const POINT* p_points, const Nat n ) override
+            {
+                points.insert( points.end(), p_points, p_points + n );
+                counts.push_back( n );
+            }
+
+            void fill_rect( in_<RECT> ) override {}
+        };
+
+        auto are_equal( in_<vector<POINT>> a, in_<vector<POINT>> b )
+            -> bool
+        {
+            return std::equal( a.begin(), a.end(), b.begin(), b.end(),
+                []( in_<POINT> p, in_<POINT> q ) { return p.x == q.x and p.y == q.y; }
+                );
+        }
+
+        auto are_equal( in_<Polyline_recorder> a, in_<Polyline_recorder> b )
+            -> bool
+        { return a.counts == b.counts and are_equal( a.points, b.points ); }
+
+        // Coefficients scaled so that the values are at most d + 1 over the plotted x range ±5000.
+        auto test_polynomial( const Nat degree )
+            -> numerics::Polynomial
+        {
+            vector<double> coefficients;
+            for( Nat j = 0; j <= degree; ++j ) {
+                coefficients.push_back( std::sin( j + 1.0 )/std::pow( 5000.0, j ) );
+            }
+            return numerics::Polynomial( coefficients );
+        }
+
+        // Plotting polynomials with forward differences versus direct evaluation, and the
+        // evaluation alone, which is what forward differences speed up; the rest of the sampling
+        // and the clipping cost the same. Fails if a forward differences value is off by more
+        // than twice the direct evaluation error bound, or if the evaluation with forward
+        // differences is slower when they’re used.
+        auto report_on_forward_differencing()
+            -> bool
+        {
+            const SIZE size = {624, 100'000};       // x is vertical, so 100 002 samples.
+            const auto transform = coordinate::Axis_relative_transform( size );
+            const Nat n_samples = size.cy + 2;
+            constexpr Nat span_size = 256;
+
+            // The sample xs, as the plotter computes them span by span.
+            auto xs = vector<double>( n_samples );
+            for( Nat i_start = 0; i_start < n_samples; i_start += span_size ) {
+                const Nat n = min( span_size, n_samples - i_start );
+                transform.math_xs_from( coordinate::Px_index( i_start - 1 ), n, xs.data() + i_start );
+            }
+            auto ys = vector<double>( n_samples );
+
+            cout << "Time per plotted polynomial sample, and per evaluation:\n";
+            bool ok = true;
+            for( const Nat degree: {2, 4, 8, 16, 24} ) {
+                const numerics::Polynomial p = test_polynomial( degree );
+                const auto direct = [&p]( const double x ) -> double { return p( x ); };
+                const auto direct_plotter = Function_plotter_<decltype( direct )>( direct );
+                const auto differences_plotter = Function_plotter_<numerics::Polynomial>( p );
+
+                auto surface = Null_surface();
+                const double direct_time = seconds_per_call_of( [&]{ direct_plotter.plot( surface, transform ); } );
+                const double differences_time = seconds_per_call_of( [&]{ differences_plotter.plot( surface, transform ); } );
+
+                const auto evaluate_spans = [&]( auto&& evaluate ) -> void
+                {
+                    for( Nat i_start = 0; i_start < n_samples; i_start += span_size ) {
+                        const Nat n = min( span_size, n_samples - i_start );
+                        evaluate( xs.data() + i_start, n, ys.data() + i_start );
+                    }
+                };
+                const double direct_evaluation_time = seconds_per_call_of( [&]{
+                    evaluate_spans( Span_evaluator_<decltype( direct )>( direct, transform.math_x_step() ) );
+                } );
+                const double differences_evaluation_time = seconds_per_call_of( [&]{
+                    evaluate_spans( Span_evaluator_<numerics::Polynomial>( p, transform.math_x_step() ) );
+                } );
+
+                // Accuracy over the same spans as the plotting.
+                auto evaluate = Span_evaluator_<numerics::Polynomial>( p, transform.math_x_step() );
+                evaluate_spans( evaluate );
+                double max_error_ratio = 0;
+                for( Nat k = 0; k < n_samples; ++k ) {
+                    max_error_ratio = max( max_error_ratio, std::abs( ys[k] - p( xs[k] ) )/p.error_bound_at( xs[k] ) );
+                }
+
+                // Before clipping, so that all samples are compared.
+                const vector<POINT> direct_points = direct_plotter.sampled_points( transform );
+                const vector<POINT> differences_points = differences_plotter.sampled_points( transform );
+                const bool is_same_shape = (direct_points.size() == differences_points.size());
+                Nat n_different = 0;
+                if( is_same_shape ) {
+                    for( size_t i = 0; i < direct_points.size(); ++i ) {
+                        n_different += (direct_points[i].x != differences_points[i].x);
+                    }
+                }
+
+                const bool is_accurate = (max_error_ratio <= 2);
+                const bool is_used = (evaluate.period() > 0);
+                const bool is_faster = (not is_used or differences_evaluation_time < direct_evaluation_time);
+                ok = ok and is_accurate and is_same_shape and is_faster;
+                cout << "    Degree " << degree << ": " << 1e9*direct_time/n_samples << " ns direct, "
+                     << 1e9*differences_time/n_samples << " ns with ";
+                if( not is_used ) {
+                    cout << "drift that falls back to direct evaluation";
+                } else if( evaluate.period() >= n_samples ) {
+                    cout << "forward differences anchored once";
+                } else {
+                    cout << "forward differences re-anchored every " << evaluate.period() << " samples";
+                }
+                cout << "; evaluation alone " << 1e9*direct_evaluation_time/n_samples << " ns versus "
+                     << 1e9*differences_evaluation_time/n_samples << " ns; max deviation "
+                     << max_error_ratio << " of the direct error bound, " << n_different << " pixel(s) differ"
+                     << (not is_same_shape? ", BUT THE NUMBERS OF POINTS DIFFER."
+                        : not is_accurate? ", BUT THAT’S NOT ACCURATE ENOUGH."
+                        : not is_faster? ", BUT THE FORWARD DIFFERENCES ARE SLOWER." : ".") << "\n";
+            }
+            return ok;
+        }
+
+        // The fixed point functions of `Indices_transform` versus the `double` ones, for every
+        // pixel index in [-2¹⁵, 2¹⁵) and every fixed point math value in that range, and the
+        // integer only plotting of the parabola versus plotting it in `double` over that range.
+        // Fails if any result differs.
+        auto report_on_fixed_point_transform()
+            -> bool
+        {
+            using coordinate::Px_index, coordinate::Fixed_math_value;
+            using Ct = coordinate::Axis_relative_transform;
+            struct Double_parabola{ auto operator()( const double x ) const -> double { return Parabola()( x ); } };
+
+            const Nat i_px_limit = 1 << 15;
+            const SIZE size = {624, 2*i_px_limit - 2};     // Plotted rows -2¹⁵ through 2¹⁵ - 1.
+            const auto transform = Ct( size );
+            const auto& _ = transform;
+
+            Nat n_differences = 0;
+            for( Nat i = -i_px_limit; i < i_px_limit; ++i ) {
+                const auto i_px = Px_index( i );
+                n_differences += (Ct::math_value_from( _.fixed_math_x_from( i_px ) ) != _.math_x_from( i_px ));
+                n_differences += (Ct::math_value_from( _.fixed_math_y_from( i_px ) ) != _.math_y_from( i_px ));
+            }
+            const std::int64_t units_limit = std::int64_t( i_px_limit )*Ct::fixed_units_per_px;
+            for( std::int64_t units = -units_limit; units < units_limit; ++units ) {
+                const auto v = Fixed_math_value( units );
+                const double dv = Ct::math_value_from( v );
+                n_differences += (_.px_index_from_fixed_math_x( v ) != _.px_index_from_math_x( dv ));
+                n_differences += (_.px_index_from_fixed_math_y( v ) != _.px_index_from_math_y( dv ));
+            }
+
+            const auto fixed_plotter = Function_plotter_<Parabola>( Parabola() );
+            const auto double_plotter = Function_plotter_<Double_parabola>( Double_parabola() );
+            const bool same_points = are_equal(     // Before clipping, so that all samples are compared.
+                fixed_plotter.sampled_points( transform ), double_plotter.sampled_points( transform )
+                );
+
+            Null_surface surface;
+            const double n_samples = size.cy + 2;
+            const double fixed_time = seconds_per_call_of( [&]{ fixed_plotter.plot( surface, transform ); } );
+            const double double_time = seconds_per_call_of( [&]{ double_plotter.plot( surface, transform ); } );
+
+            const bool ok = (n_differences == 0 and same_points);
+            cout << "Fixed point versus double transform for pixel indices in ±" << i_px_limit << ": "
+                 << n_differences << " difference(s), " << (same_points? "same" : "DIFFERENT")
+                 << " parabola points; " << 1e9*double_time/n_samples << " ns per sample in double, "
+                 << 1e9*fixed_time/n_samples << " ns integer only.\n";
+            return ok;
+        }
+
+        // Scatter points over the visible area, transformed one by one with `px_pt_from` versus as
+        // a structure of arrays batch, for each pixel handedness. 4096 points fit in the L1 and L2
+        // caches, while 10⁶ points are limited by memory bandwidth. Fails if the batch results
+        // differ from the one by one results.
+        auto report_on_batch_transform()
+            -> bool
+        {
+            using geometry::Handedness;
+            const auto transform = coordinate::Axis_relative_transform( default_size );
+            const auto& _ = transform;
+
+            bool ok = true;
+            cout << "Transforming scatter points:\n";
+            for( const Nat n: {4096, 1'000'000} ) {
+                auto xs = vector<double>( n );
+                auto ys = vector<double>( n );
+                for( Nat k = 0; k < n; ++k ) {
+                    const double a = 0.5 + 0.5*std::sin( 1.1*k );
+                    const double b = 0.5 + 0.5*std::sin( 0.7*k + 1 );
+                    xs[k] = _.math_minimum_x() + a*(_.math_maximum_x() - _.math_minimum_x());
+                    ys[k] = _.math_minimum_y() + b*(_.math_maximum_y() - _.math_minimum_y());
+                }
+
+                auto points = vector<POINT>( n );
+                auto px_xs = vector<int>( n );
+                auto px_ys = vector<int>( n );
+                auto up_px_xs = vector<int>( n );
+                auto up_px_ys = vector<int>( n );
+                const auto one_by_one = [&]{
+                    for( Nat k = 0; k < n; ++k ) { points[k] = _.px_pt_from( {xs[k], ys[k]} ); }
+                };
+                const auto batch = [&]{
+                    _.px_pts_from( xs.data(), ys.data(), n, px_xs.data(), px_ys.data() );
+                };
+                const auto y_up_batch = [&]{
+                    _.px_pts_from<Handedness::like_math>( xs.data(), ys.data(), n, up_px_xs.data(), up_px_ys.data() );
+                };
+                one_by_one();  batch();  y_up_batch();
+
+                bool is_same = true;
+                for( Nat k = 0; k < n; ++k ) {
+                    is_same = is_same and px_xs[k] == points[k].x and px_ys[k] == points[k].y
+                        and up_px_xs[k] == points[k].x and up_px_ys[k] == default_size.cy - 1 - points[k].y;
+                }
+                ok = ok and is_same;
+
+                const double one_by_one_time = seconds_per_call_of( one_by_one );
+                const double batch_time = seconds_per_call_of( batch );
+                const double y_up_batch_time = seconds_per_call_of( y_up_batch );
+                cout << "    " << n << " points: " << 1e9*one_by_one_time/n << " ns per point one by one, "
+                     << 1e9*batch_time/n << " ns as a batch, " << 1e9*y_up_batch_time/n << " ns as a batch with y up"
+                     << (is_same? "." : ", BUT THE RESULTS DIFFER.") << "\n";
+            }
+            return ok;
+        }
+
+        // Tick end points for every `td` math units along both axes, with the axis a run time
+        // value as in a loop over `Ct::math_axes`.
+        void add_tick_points_with_run_time_axes(
+            in_<coordinate::Axis_relative_transform>    transform,
+            const double                                td,
+            vector<POINT>&                              points
+            )
+        {
+            using Ct = coordinate::Axis_relative_transform;
+            const auto& _ = transform;
+            for( const auto axis: Ct::math_axes ) {
+                const coordinate::Px_point_vector extent = 2*rotl( _.px_unit_vector_for( axis ) );
+                const double first_v = td*trunc( _.math_minimum( axis )/td );
+                const double last_v = _.math_maximum( axis );
+                for( Nat i = 0; first_v + i*td <= last_v; ++i ) {
+                    const POINT pt = _.px_pt_from( axis, first_v + i*td );
+                    points.push_back( pt - extent );  points.push_back( pt + extent );
+                }
+            }
+        }
+
+        // As `add_tick_points_with_run_time_axes`, but with the axis a compile time constant.
+        void add_tick_points_with_compile_time_axes(
+            in_<coordinate::Axis_relative_transform>    transform,
+            const double                                td,
+            vector<POINT>&                              points
+            )
+        {
+            using Ct = coordinate::Axis_relative_transform;
+            const auto& _ = transform;
+            Ct::for_each_math_axis( [&]( const auto axis_constant ) {
+                constexpr auto axis = decltype( axis_constant )::value;
+                const coordinate::Px_point_vector extent = 2*rotl( _.px_unit_vector_for<axis>() );
+                const double first_v = td*trunc( _.math_minimum<axis>()/td );
+                const double last_v = _.math_maximum<axis>();
+                for( Nat i = 0; first_v + i*td <= last_v; ++i ) {
+                    const POINT pt = _.px_pt_from<axis>( first_v + i*td );
+                    points.push_back( pt - extent );  points.push_back( pt + extent );
+                }
+            } );
+        }
+
+        // Dense ticks, one per pixel along both axes of a 7680×4320 frame, as for a grid, with
+        // run time versus compile time axes. Fails if the tick points differ.
+        auto report_on_axis_dispatch()
+            -> bool
+        {
+            const SIZE size = {7680, 4320};
+            const auto transform = coordinate::Axis_relative_transform( size );
+            const double td = transform.math_x_step();
+
+            vector<POINT> run_time_points;
+            vector<POINT> compile_time_points;
+            add_tick_points_with_run_time_axes( transform, td, run_time_points );
+            add_tick_points_with_compile_time_axes( transform, td, compile_time_points );
+            const bool ok = are_equal( run_time_points, compile_time_points );
+            const double n_ticks = run_time_points.size()/2;
+
+            const double run_time_time = seconds_per_call_of( [&]{
+                run_time_points.clear();
+                add_tick_points_with_run_time_axes( transform, td, run_time_points );
+            } );
+            const double compile_time_time = seconds_per_call_of( [&]{
+                compile_time_points.clear();
+                add_tick_points_with_compile_time_axes( transform, td, compile_time_points );
+            } );
+            cout << "Computing " << n_ticks << " dense ticks: " << 1e9*run_time_time/n_ticks
+                 << " ns per tick with run time axes, " << 1e9*compile_time_time/n_ticks
+                 << " ns with compile time axes" << (ok? "." : ", BUT THE POINTS DIFFER.") << "\n";
+            return ok;
+        }
+
+        // Counts the polylines and points drawn on it, and checks that the points are within the
+        // guard limits of `graphics::for_each_clipped_run`.
+        struct Clipped_polylines_checker: graphics::Surface
+        {
+            Nat     n_polylines         = 0;
+            Nat     n_points            = 0;
+            bool    all_are_inside      = true;
+
+            void polyline( const POINT* points, const Nat n ) override
+            {
+                const Nat limit = graphics::clipping_guard_limit;
+                ++n_polylines;  n_points += n;
+                for( Nat i = 0; i < n; ++i ) {
+                    const POINT& p = points[i];
+                    all_are_inside = all_are_inside
+                        and -limit <= p.x and p.x <= limit and -limit <= p.y and p.y <= limit;
+                }
+            }
+
+            void fill_rect( in_<RECT> ) override {}
+        };
+
+        // The parabola plotted with the clipping stage versus its unclipped sample polyline, at the
+        // default size and with 10⁵ rows where most of it is far outside, and x⁴ with 10⁵ rows
+        // where `int( scaling*y )` would overflow. Fails if any pixels differ, if a drawn point is
+        // beyond the guard limits, or if the x⁴ pixels differ from those of x⁴ capped at 10⁶.
+        auto report_on_clipping()
+            -> bool
+        {
+            using Ct = coordinate::Axis_relative_transform;
+            bool ok = true;
+
+            cout << "Clipping the plotted polyline to the client area:\n";
+            for( const SIZE size: {default_size, SIZE{ 624, 100'000 }} ) {
+                const auto transform = Ct( size );
+                vector<POINT> unclipped;
+                for( Nat i_row = -1; i_row <= size.cy; ++i_row ) {
+                    const double x = transform.math_x_from( coordinate::Px_index( i_row ) );
+                    unclipped.push_back( transform.px_pt_from( {x, Parabola()( x )} ) );
+                }
+
+                auto checker = Clipped_polylines_checker();
+                the_parabola_plotter.plot( checker, transform );
+
+                const auto [unclipped_time, clipped_time, is_same] = compared_drawings( size,
+                    [&]( Rgba_framebuffer& image ) {
+                        Framebuffer_surface( image ).polyline( unclipped.data(), Nat( unclipped.size() ) );
+                    },
+                    [&]( Rgba_framebuffer& image ) {
+                        auto surface = Framebuffer_surface( image );
+                        the_parabola_plotter.plot( surface, transform );
+                    } );
+                ok = ok and checker.all_are_inside and is_same;
+
+                cout << "    x²/4 at " << size.cx << "×" << size.cy << ": " << unclipped.size() << " points in "
+                     << 1e3*unclipped_time << " ms rasterized unclipped, " << checker.n_points << " points in "
+                     << checker.n_polylines << " polyline(s) in " << 1e3*clipped_time << " ms sampled, clipped and rasterized, "
+                     << (is_same? "same pixels" : "BUT SOME PIXELS DIFFER")
+                     << (checker.all_are_inside? "." : ", AND SOME POINTS ARE BEYOND THE GUARD LIMITS.") << "\n";
+            }
+
+            const SIZE size = {624, 100'000};
+            const auto transform = Ct( size );
+            const auto x4_plotter = Function_plotter_<Runtime_function>(
+                []( const double x ) -> double { return x*x*x*x; }
+                );
+            const auto capped_x4_plotter = Function_plotter_<Runtime_function>(
+                []( const double x ) -> double { return min( x*x*x*x, 1e6 ); }
+                );
+            auto checker = Clipped_polylines_checker();
+            x4_plotter.plot( checker, transform );
+            auto image = Rgba_framebuffer( size, orange );
+            auto surface = Framebuffer_surface( image );
+            auto capped_image = Rgba_framebuffer( size, orange );
+            auto capped_surface = Framebuffer_surface( capped_image );
+            x4_plotter.plot( surface, transform );
+            capped_x4_plotter.plot( capped_surface, transform );
+            const bool is_safe = (checker.all_are_inside and image == capped_image);
+            ok = ok and is_safe;
+            cout << "    x⁴ at " << size.cx << "×" << size.cy << ", up to " << std::pow( transform.math_maximum_x(), 4 )
+                 << ": " << checker.n_points << " points in " << checker.n_polylines << " polyline(s), "
+                 << (is_safe? "same pixels as capped." : "BUT THE PIXELS ARE WRONG.") << "\n";
+            return ok;
+        }
+
+        // The lines of a 1920×1080 grid with a line every 4 pixels, as in a grid-heavy chart,
+        // drawn with Bresenham’s algorithm plus a call for the endpoint, versus `graphics::draw_line`
+        // with its single call and span fills. Fails if the pixels differ.
+        auto report_on_axis_aligned_lines()
+            -> bool
+        {
+            using Line = std::pair<POINT, POINT>;
+            const SIZE size = {1920, 1080};
+            const Nat spacing = 4;
+            vector<Line> horizontal_lines;
+            vector<Line> vertical_lines;
+            for( Nat y = 0; y < size.cy; y += spacing ) { horizontal_lines.push_back( {{0, y}, {size.cx - 1, y}} ); }
+            for( Nat x = 0; x < size.cx; x += spacing ) { vertical_lines.push_back( {{x, size.cy - 1}, {x, 0}} ); }
+
+            bool ok = true;
+            cout << "Drawing the lines of a " << size.cx << "×" << size.cy << " grid:\n";
+            for( const auto& [kind, lines]: {std::pair{ "horizontal", horizontal_lines }, {"vertical", vertical_lines}} ) {
+                const auto black = rgba( 0, 0, 0 );
+                const auto [bresenham_time, span_time, is_same] = compared_drawings( size,
+                    [&]( Rgba_framebuffer& image ) {
+                        for( const auto& [from, to]: lines ) {
+                            image.draw_bresenham_line_sans_endpoint( from, to, black, image.bounds() );
+                            image.draw_bresenham_line_sans_endpoint( to, {to.x + 1, to.y}, black, image.bounds() );
+                        }
+                    },
+                    [&]( Rgba_framebuffer& image ) {
+                        auto surface = Framebuffer_surface( image );
+                        for( const auto& [from, to]: lines ) { graphics::draw_line( surface, from, to ); }
+                    } );
+                ok = ok and is_same;
+
+                cout << "    " << lines.size() << " " << kind << " lines: " << 1e3*bresenham_time
+                     << " ms with Bresenham and an endpoint call, " << 1e3*span_time << " ms with span fills in one call"
+                     << (is_same? "." : ", BUT THE PIXELS DIFFER.") << "\n";
+            }
+            return ok;
+        }
+
+        // Counts the surface calls and the primitives drawn by them, and forwards them to `target`.
+        // With `is_batching` it offers a batch, like `winapi::Dc_surface`.
+        struct Call_counting_surface: graphics::Surface
+        {
+            graphics::Surface&          target;
+            bool                        is_batching;
+            graphics::Primitive_batch   a_batch;
+            Nat                         n_calls         = 0;
+            Nat                         n_primitives    = 0;
+
+            Call_counting_surface( graphics::Surface& a_target, const bool batching = false ):
+                target( a_target ), is_batching( batching )
+            {}
+
+            auto batch() -> graphics::Primitive_batch* override { return (is_batching? &a_batch : nullptr); }
+
+            void polyline( const POINT* points, const Nat n ) override
+            {
+                ++n_calls;  ++n_primitives;  target.polyline( points, n );
+            }
+
+            void fill_rect( in_<RECT> r ) override
+            {
+                ++n_calls;  ++n_primitives;  target.fill_rect( r );
+            }
+
+            void poly_polyline( const POINT* points, const Nat* const counts, const Nat n_polylines ) override
+            {
+                ++n_calls;  n_primitives += n_polylines;  target.poly_polyline( points, counts, n_polylines );
+            }
+
+            void fill_rects( const RECT* const rects, const Nat n ) override
+            {
+                ++n_calls;  n_primitives += n;  target.fill_rects( rects, n );
+            }
+        };
+
+        // A 1920×1080 chart with 10 000 ticks and 10 000 markers drawn one call per primitive versus
+        // batched by kind, plus the calls of a frame of the painter. Fails if the pixels differ.
+        auto report_on_batched_primitives()
+            -> bool
+        {
+            const SIZE size = {1920, 1080};
+            const Nat n = 10'000;
+            const auto draw_chart = [&]( graphics::Surface& surface ) {
+                for( Nat i = 0; i < n; ++i ) {
+                    const POINT pt = {10 + i % 1900, 50 + i/1900*100};
+                    graphics::draw_line( surface, {pt.x, pt.y - 2}, {pt.x, pt.y + 2} );
+                }
+                for( Nat i = 0; i < n; ++i ) {
+                    const POINT pt = {i*7 % (size.cx - 5), i*13 % (size.cy - 5)};
+                    surface.fill_rect( {pt.x, pt.y, pt.x + 5, pt.y + 5} );
+                }
+            };
+
+            graphics::Primitive_batch batch;
+            const auto draw_batched = [&]( graphics::Surface& surface ) {
+                batch.clear();
+                draw_chart( batch );
+                batch.submit_to( surface );
+            };
+            const auto [direct_time, batched_time, ok] = compared_drawings( size,
+                [&]( Rgba_framebuffer& image ) { auto surface = Framebuffer_surface( image );  draw_chart( surface ); },
+                [&]( Rgba_framebuffer& image ) { auto surface = Framebuffer_surface( image );  draw_batched( surface ); }
+                );
+
+            auto null_surface = Null_surface();
+            auto direct_counter = Call_counting_surface( null_surface );
+            draw_chart( direct_counter );
+            auto batched_counter = Call_counting_surface( null_surface );
+            draw_batched( batched_counter );
+
+            cout << "Drawing " << n << " ticks and " << n << " markers at " << size.cx << "×" << size.cy << ": "
+                 << direct_counter.n_calls << " calls in " << 1e3*direct_time << " ms one by one, "
+                 << batched_counter.n_calls << " calls in " << 1e3*batched_time << " ms batched"
+                 << (ok? "." : ", BUT THE PIXELS DIFFER.") << "\n";
+
+            // The painter draws a framebuffer directly, since batching there only adds copying,
+            // and batches for a surface that offers a batch, as a DC does.
+            auto painter_image = Rgba_framebuffer( default_size, orange );
+            auto painter_surface = Framebuffer_surface( painter_image );
+            auto painter_counter = Call_counting_surface( painter_surface );
+            Painter( painter_counter, default_size ).paint();
+            auto batched_painter_image = Rgba_framebuffer( default_size, orange );
+            auto batched_painter_surface = Framebuffer_surface( batched_painter_image );
+            auto batched_painter_counter = Call_counting_surface( batched_painter_surface, true );
+            Painter( batched_painter_counter, default_size ).paint();
+            const bool is_same_frame = (painter_image == batched_painter_image);
+            cout << "    A painter frame at " << default_size.cx << "×" << default_size.cy << ": "
+                 << painter_counter.n_calls << " calls directly, "
+                 << batched_painter_counter.n_calls << " calls for " << batched_painter_counter.n_primitives
+                 << " primitives via a batch"
+                 << (is_same_frame? "." : ", BUT THE PIXELS DIFFER.") << "\n";
+            return ok and is_same_frame;
+        }
+
+        // A series of `n` noisy samples over the visible x range, plotted naively and with M4
+        // decimation on 1, 2, 4, … threads. Fails if the pixels differ.
+        auto report_on_m4_decimation( const size_t n )
+            -> bool
+        {
+            const auto transform = coordinate::Axis_relative_transform( default_size );
+            const double x_first = transform.math_minimum_x();
+            const double x_step = (transform.math_maximum_x() - x_first)/n;
+
+            auto xs = vector<double>( n );
+            auto ys = vector<double>( n );
+            uint32_t random_state = 42;
+            for( size_t i = 0; i < n; ++i ) {
+                random_state = 1'664'525*random_state + 1'013'904'223;     // Numerical Recipes LCG.
+                const double noise = 6.0*(random_state >> 8)/(1 << 24) - 3;
+                xs[i] = x_first + i*x_step;
+                ys[i] = 25 + 10*std::abs( std::fmod( xs[i]/5, 2.0 ) ) + noise;      // Sawtooth-like.
+            }
+            const auto series = Series_arrays{ xs.data(), ys.data(), n };
+
+            // Naively, in chunks of points that overlap by one, which draws the same pixels.
+            auto naive = Rgba_framebuffer( default_size, orange );
+            auto naive_surface = Framebuffer_surface( naive );
+            const double naive_time = seconds_for( [&]{
+                vector<POINT> points;
+                for( size_t i_first = 0; i_first + 1 < n; i_first += 1'000'000 ) {
+                    const size_t i_beyond = std::min( n, i_first + 1'000'001 );
+                    points.clear();
+                    for( size_t i = i_first; i < i_beyond; ++i ) { points.push_back( transform.px_pt_from( {xs[i], ys[i]} ) ); }
+                    naive_surface.polyline( points.data(), Nat( points.size() ) );
+                }
+            } );
+
+            auto decimated = Rgba_framebuffer( default_size, orange );
+            auto decimated_surface = Framebuffer_surface( decimated );
+            Series_plotter_<Series_arrays>( series ).plot( decimated_surface, transform );
+            auto recorder = Polyline_recorder();
+            Series_plotter_<Series_arrays>( series ).plot( recorder, transform );
+
+            const bool is_same = (naive == decimated);
+            cout << "Plotting " << n << " samples at " << default_size.cx << "×" << default_size.cy << ": "
+                 << 1e-6*n/naive_time << " million samples/s naively, "
+                 << recorder.points.size() << " points after M4 decimation"
+                 << (is_same? ", same pixels." : ", BUT THE PIXELS DIFFER.") << "\n";
+
+            auto surface = Null_surface();
+            const Nat n_max_threads = max<Nat>( 4, thread::hardware_concurrency() );
+            for( Nat n_threads = 1; n_threads <= n_max_threads; n_threads *= 2 ) {
+                const auto plotter = Series_plotter_<Series_arrays>( series, n_threads );
+                const double time = seconds_per_call_of( [&]{ plotter.plot( surface, transform ); } );
+                cout << "    " << n_threads << " thread(s): " << 1e-6*n/time << " million samples/s.\n";
+            }
+            return is_same;
+        }
+
+        template< class Value >
+        auto save_as_raw( const vector<Value>& values, in_<fs::path> file_path )
+            -> bool
+        {
+            auto f = std::ofstream( file_path, std::ios::binary );
+            f.write( reinterpret_cast<const char*>( values.data() ), std::streamsize( sizeof( Value )*values.size() ) );
+            return not f.fail();
+        }
+
+        // Mapped series plotted the same as the in-memory arrays, with each file layout variant.
+        auto report_on_mapped_series()
+            -> bool
+        {
+            const size_t n = 4'000'000;
+            const auto transform = coordinate::Axis_relative_transform( default_size );
+            const double x_first = 2*transform.math_minimum_x();        // Half of it visible.
+            const double x_step = 2*(transform.math_maximum_x() - transform.math_minimum_x())/n;
+
+            vector<double> xs( n );  vector<double> ys( n );
+            vector<double> records;  vector<float> float_ys;
+            for( size_t i = 0; i < n; ++i ) {
+                xs[i] = x_first + double( i )*x_step;
+                ys[i] = float( 30 + 20*std::sin( xs[i] ) );     // Exactly representable as `float`.
+                records.insert( records.end(), {xs[i], ys[i]} );
+                float_ys.push_back( float( ys[i] ) );
+            }
+            const fs::path records_path = files::temp_file_path( "series-records.f64" );
+            const fs::path ys_path = files::temp_file_path( "series-ys.f32" );
+            if( not (save_as_raw( records, records_path ) and save_as_raw( float_ys, ys_path )) ) { return false; }
+
+            auto expected = Polyline_recorder();
+            Series_plotter_<Series_arrays>( Series_arrays{ xs.data(), ys.data(), n } ).plot( expected, transform );
+
+            bool is_same = false;
+            {
+                const auto records_mapping = files::Read_only_mapping( records_path );
+                const auto ys_mapping = files::Read_only_mapping( ys_path );
+                using Records = Mapped_series_<double, X_column::interleaved>;
+                using Ys = Mapped_series_<float, X_column::none>;
+
+                auto from_records = Polyline_recorder();
+                auto from_ys = Polyline_recorder();
+                Series_plotter_<Records>( Records( records_mapping ) ).plot( from_records, transform );
+                Series_plotter_<Ys>( Ys( ys_mapping, x_first, x_step ) ).plot( from_ys, transform );
+                is_same = (records_mapping.is_valid() and ys_mapping.is_valid()
+                    and are_equal( from_records, expected )
+                    and are_equal( from_ys, expected ));
+            }
+            std::error_code error;
+            fs::remove( records_path, error );
+            fs::remove( ys_path, error );
+            cout << "Plotting " << n << " samples from memory-mapped files"
+                 << (is_same? " gives the same points as from memory." : " DOESN’T GIVE THE SAME POINTS AS FROM MEMORY.")
+                 << "\n";
+            return is_same;
+        }
+
+        // Writes the data out to the disk and drops the file’s pages from the page cache.
+        void evict_from_page_cache( in_<fs::path> file_path )
+        {
+            const int fd = open( file_path.c_str(), O_RDONLY );
+            if( fd < 0 ) { return; }
+            fsync( fd );
+            posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+            close( fd );
+        }
+
+        auto resident_fraction_of( in_<files::Read_only_mapping> mapping )
+            -> double
+        {
+            const size_t page_size = size_t( sysconf( _SC_PAGESIZE ) );
+            auto residency = vector<unsigned char>( (mapping.size() + page_size - 1)/page_size );
+            mincore( const_cast<void*>( mapping.data() ), mapping.size(), residency.data() );
+            size_t n_resident = 0;
+            for( const unsigned char flags: residency ) { n_resident += (flags & 1); }
+            return 1.0*n_resident/residency.size();
+        }
+
+        // Renders of 1 GB and 10 GB files of `double` y values, with a tenth of the x range visible.
+        // A cold render has the file evicted from the page cache, and includes mapping the file.
+        auto report_on_large_mapped_series()
+            -> bool
+        {
+            const auto transform = coordinate::Axis_relative_transform( default_size );
+            const double x_visible = transform.math_maximum_x() - transform.math_minimum_x();
+            using Ys = Mapped_series_<double, X_column::none>;
+
+            for( const Nat n_gb: {1, 10} ) {
+                const fs::path path = files::temp_file_path( "series-" + std::to_string( n_gb ) + "GB.f64" );
+                const size_t n = n_gb*(size_t( 1 ) << 30)/sizeof( double );
+                const double x_first = transform.math_minimum_x() - 4.5*x_visible;
+                const double x_step = 10*x_visible/n;
+
+                cout << "Writing " << n_gb << " GB to “" << path.string() << "”…" << std::endl;
+                std::error_code error;
+                {
+                    auto f = std::ofstream( path, std::ios::binary );
+                    auto chunk = vector<double>( size_t( 1 ) << 20 );
+                    for( size_t i_first = 0; i_first < n and f; i_first += chunk.size() ) {
+                        for( size_t k = 0; k < chunk.size(); ++k ) {
+                            chunk[k] = 30 + 20*std::sin( x_first + double( i_first + k )*x_step );
+                        }
+                        f.write( reinterpret_cast<const char*>( chunk.data() ), std::streamsize( sizeof( double )*chunk.size() ) );
+                    }
+                    if( f.fail() ) { fs::remove( path, error );  return false; }
+                }
+
+                const auto render = [&]( double& resident_fraction ) -> double {
+                    const auto start_time = chrono::steady_clock::now();
+                    const auto mapping = files::Read_only_mapping( path );
+                    auto surface = Null_surface();
+                    Series_plotter_<Ys>( Ys( mapping, x_first, x_step ) ).plot( surface, transform );
+                    const double time = chrono::duration<double>( chrono::steady_clock::now() - start_time ).count();
+                    resident_fraction = resident_fraction_of( mapping );
+                    return time;
+                };
+                double resident_fraction = 0;
+                evict_from_page_cache( path );
+                const double cold_time = render( resident_fraction );
+                double ignored;
+                const double warm_time = render( ignored );
+                fs::remove( path, error );
+
+                cout << "    " << n_gb << " GB: " << 1e3*cold_time << " ms cold, " << 1e3*warm_time
+                     << " ms warm, " << 100*resident_fraction << "% of the pages read.\n";
+            }
+            return true;
+        }
+
+        // Zooming over `n` samples of y in memory, from all of them visible to 10⁴ of them, with
+        // M4 decimation of all visible samples and with a min/max pyramid saved to a file and memory
+        // mapped. Fails if the points differ.
+        auto report_on_lod_pyramid( const size_t n )
+            -> bool
+        {
+            using Ys = Mapped_series_<double, X_column::none>;
+            auto ys = vector<double>( n );
+            uint32_t random_state = 42;
+            for( size_t i = 0; i < n; ++i ) {
+                random_state = 1'664'525*random_state + 1'013'904'223;     // Numerical Recipes LCG.
+                ys[i] = 30 + 20*std::sin( i*1e-6 ) + 4.0*(random_state >> 8)/(1 << 24);
+            }
+
+            vector<double> pyramid_data;
+            const double build_time = seconds_for( [&]{ pyramid_data = Min_max_pyramid::data_for( Ys( ys.data(), n ) ); } );
+            const fs::path pyramid_path = files::temp_file_path( "series.minmax" );
+            if( not save_as_raw( pyramid_data, pyramid_path ) ) { return false; }
+            cout << "Indexing " << n << " samples: " << 1e3*build_time << " ms, "
+                 << 100.0*pyramid_data.size()/n << "% of the series size.\n";
+
+            bool ok = true;
+            {
+                const auto mapping = files::Read_only_mapping( pyramid_path );
+                const auto pyramid = Min_max_pyramid( static_cast<const double*>( mapping.data() ) );
+                const auto transform = coordinate::Axis_relative_transform( default_size );
+                const double x_visible = transform.math_maximum_x() - transform.math_minimum_x();
+                const double x_middle = transform.math_minimum_x() + x_visible/2;
+
+                auto surface = Null_surface();
+                for( double zoom = 1; n/zoom >= 1e4; zoom *= 10 ) {
+                    const double x_step = zoom*x_visible/n;
+                    const auto series = Ys( ys.data(), n, x_middle - 0.5*n*x_step, x_step );
+                    const auto full = Series_plotter_<Ys>( series );
+                    const auto lod = Lod_series_plotter_<Ys>( series, pyramid );
+
+                    auto full_points = Polyline_recorder();  auto lod_points = Polyline_recorder();
+                    full.plot( full_points, transform );
+                    lod.plot( lod_points, transform );
+                    const bool is_same = are_equal( full_points, lod_points );
+                    ok = ok and is_same;
+
+                    const double full_time = seconds_per_call_of( [&]{ full.plot( surface, transform ); } );
+                    const double lod_time = seconds_per_call_of( [&]{ lod.plot( surface, transform ); } );
+                    cout << "    " << size_t( n/zoom ) << " samples visible: " << 1e3*full_time << " ms per frame scanning them, "
+                         << 1e3*lod_time << " ms with the index"
+                         << (is_same? "." : ", BUT THE POINTS DIFFER.") << "\n";
+                }
+            }
+            std::error_code error;
+            fs::remove( pyramid_path, error );
+            return ok;
+        }
+
+        // An in-memory event source that replays a script. It’s also the platform of the window:
+        // the screen is a framebuffer that’s resized by size events, and like in Windows an
+        // invalidation is delivered as a paint event when no scripted event is queued.
+        //
+        // Without arrival times each scripted event is queued only when the previous one has been
+        // handled, which is deterministic. With arrival times, in seconds from the first `next`
+        // call, the events are replayed in real time, and consecutive queued size events are
+        // coalesced to the last one, like mouse moves in Windows.
+        class Scripted_event_source: public events::Event_source
+        {
+            using Event = events::Event;
+            using Clock = chrono::steady_clock;
+
+            const vector<Event>&    m_script;
+            vector<double>          m_arrival_times;
+            Clock::time_point       m_start_time;
+            size_t                  m_i_next        = 0;
+            Nat                     m_n_coalesced   = 0;
+            SIZE                    m_screen_size   = {0, 0};
+            Rgba_framebuffer        m_screen        = Rgba_framebuffer( SIZE{ 0, 0 }, orange );
+            RECT                    m_invalid       = {};
+            bool                    m_has_quit      = false;
+
+            auto arrival_time_of( const size_t i ) const -> Clock::time_point
+            {
+                return m_start_time + chrono::duration_cast<Clock::duration>(
+                    chrono::duration<double>( m_arrival_times[i] )
+                    );
+            }
+
+            auto is_queued( const size_t i ) const
+                -> bool
+            { return i < m_script.size() and not m_arrival_times.empty() and arrival_time_of( i ) <= Clock::now(); }
+
+        public:
+            using Backbuffer = Framebuffer_backbuffer;
+
+            explicit Scripted_event_source( in_<vector<Event>> script, vector<double> arrival_times = {} ):
+                m_script( script ),
+                m_arrival_times( move( arrival_times ) )
+            {}
+
+            auto next( Event& e ) -> bool override
+            {
+                if( m_has_quit ) { return false; }
+                if( m_i_next == 0 ) { m_start_time = Clock::now(); }
+                if( not graphics::is_empty( m_invalid ) and not is_queued( m_i_next ) ) {
+                    e = {Event::Kind::paint, {}, m_invalid};
+                    m_invalid = {};
+                    return true;
+                }
+                if( m_i_next == m_script.size() ) { return false; }
+                if( not m_arrival_times.empty() ) { std::this_thread::sleep_until( arrival_time_of( m_i_next ) ); }
+                e = m_script[m_i_next++];
+                if( e.kind == Event::Kind::size ) {
+                    while( is_queued( m_i_next ) and m_script[m_i_next].kind == Event::Kind::size ) {
+                        e = m_script[m_i_next++];
+                        ++m_n_coalesced;
+                    }
+                    m_screen_size = e.size;
+                }
+                return true;
+            }
+
+            auto n_coalesced() const -> Nat { return m_n_coalesced; }
+
+            auto screen() const -> const Rgba_framebuffer& { return m_screen; }
+
+            // The screen is resized when it’s painted, so that a size event is cheap.
+            auto paint_target()
+                -> Rgba_framebuffer&
+            {
+                const RECT r = m_screen.bounds();
+                if( r.right != m_screen_size.cx or r.bottom != m_screen_size.cy ) {
+                    m_screen = Rgba_framebuffer( m_screen_size, orange );
+                }
+                return m_screen;
+            }
+
+            void invalidate_all() { m_invalid = {0, 0, m_screen_size.cx, m_screen_size.cy}; }
+            void quit( Process_exit_code ) { m_has_quit = true; }
+        };
+
+        // 10⁶ events: mostly exposes of 32×32 areas, a size change every 1000 events, and a destroy.
+        auto event_script()
+            -> vector<events::Event>
+        {
+            using Event = events::Event;
+            const Nat n = 1'000'000;
+            const SIZE sizes[] = { default_size, {default_size.cx + 8, default_size.cy} };
+
+            vector<Event> result;
+            for( Nat i = 0; i < n - 1; ++i ) {
+                if( i % 1000 == 0 ) {
+                    result.push_back( {Event::Kind::size, sizes[i/1000 % 2], {}} );
+                } else {
+                    const Nat x = i*37 % (default_size.cx - 32);
+                    const Nat y = i*53 % (default_size.cy - 32);
+                    result.push_back( {Event::Kind::paint, {}, {x, y, x + 32, y + 32}} );
+                }
+            }
+            result.push_back( {Event::Kind::destroy, {}, {}} );
+            return result;
+        }
+
+        // Replays the event script through the portable window, for the dispatch throughput and
+        // the latency of each handler. Fails if the final pixels are not those of a full repaint,
+        // or if the window rendered other than once per size change.
+        auto report_on_event_dispatch()
+            -> bool
+        {
+            using Event = events::Event;
+            const vector<Event> script = event_script();
+            Nat n_size_events = 0;
+            SIZE final_size = {};
+            for( const Event& e: script ) {
+                if( e.kind == Event::Kind::size ) { ++n_size_events;  final_size = e.size; }
+            }
+
+            auto source = Scripted_event_source( script );
+            auto window = Main_window_<Scripted_event_source>( source, orange );
+            const double time = seconds_for( [&]{ events::run_event_loop( source, window ); } );
+            const bool ok = (source.screen() == painted_frame( final_size ) and window.n_renders() == n_size_events);
+
+            // Per handler, with a paint that renders counted separately from one that only copies.
+            struct Stats{ C_str name; Nat n; double total; double max; };
+            Stats stats[] = {{"size", 0, 0, 0}, {"paint (copy)", 0, 0, 0}, {"paint (render)", 0, 0, 0}, {"destroy", 0, 0, 0}};
+            auto timed_source = Scripted_event_source( script );
+            auto timed_window = Main_window_<Scripted_event_source>( timed_source, orange );
+            Event e;
+            while( timed_source.next( e ) ) {
+                const Nat n_renders_before = timed_window.n_renders();
+                const double event_time = seconds_for( [&]{ timed_window.handle( e ); } );
+                Stats& s = stats[
+                    e.kind == Event::Kind::size? 0 : e.kind == Event::Kind::destroy? 3
+                    : timed_window.n_renders() == n_renders_before? 1 : 2
+                    ];
+                ++s.n;  s.total += event_time;  s.max = max( s.max, event_time );
+            }
+
+            cout << "Dispatching " << script.size() << " scripted events: " << 1e-6*script.size()/time
+                 << " million events/s, with " << window.n_renders() << " renders"
+                 << (ok? "." : ", BUT THE RESULT IS WRONG.") << "\n";
+            for( const Stats& s: stats ) {
+                cout << "    " << s.name << ": " << s.n << " events, " << 1e6*s.total/max( 1, s.n )
+                     << " µs average, " << 1e6*s.max << " µs max.\n";
+            }
+            return ok;
+        }
+
+        // A live resize from 1280×720 that grows by 1 pixel in each direction per size event.
+        // First with all events queued at once, where the size events must coalesce into one
+        // render. Then replayed in real time, one size event per millisecond. There the coalescing
+        // depends on the machine’s speed, so the frame times are only reported, and the checks are
+        // that each size event is either delivered or coalesced, that there is at most one render
+        // per delivered size event, and that the final pixels are those of a full repaint.
+        auto report_on_live_resize()
+            -> bool
+        {
+            using Event = events::Event;
+            const Nat n_sizes = 1000;
+            const double interval = 0.001;
+
+            vector<Event> script;
+            for( Nat i = 0; i < n_sizes; ++i ) {
+                script.push_back( {Event::Kind::size, {1280 + i, 720 + i}, {}} );
+            }
+            const SIZE final_size = script.back().size;
+            // No destroy: the replay ends when the script is done and the final frame painted.
+
+            const Rgba_framebuffer expected = painted_frame( final_size );
+
+            bool ok = true;
+            {
+                auto source = Scripted_event_source( script, vector<double>( script.size(), 0.0 ) );
+                auto window = Main_window_<Scripted_event_source>( source, orange );
+                events::run_event_loop( source, window );
+                const bool is_correct = (
+                    source.n_coalesced() == n_sizes - 1 and window.n_renders() == 1 and source.screen() == expected
+                    );
+                ok = ok and is_correct;
+                cout << "Live resize to " << final_size.cx << "×" << final_size.cy << " with all events queued: "
+                     << n_sizes << " size events, " << source.n_coalesced() << " coalesced, "
+                     << window.n_renders() << " render(s)" << (is_correct? "." : ", BUT THE RESULT IS WRONG.") << "\n";
+            }
+
+            vector<double> arrival_times;
+            for( size_t i = 0; i < script.size(); ++i ) { arrival_times.push_back( interval*double( i ) ); }
+            auto source = Scripted_event_source( script, arrival_times );
+            auto window = Main_window_<Scripted_event_source>( source, orange );
+
+            Nat n_delivered_sizes = 0;
+            double render_time = 0;
+            double max_render_time = 0;
+            Event e;
+            while( source.next( e ) ) {
+                if( e.kind == Event::Kind::size ) { ++n_delivered_sizes; }
+
+                const Nat n_renders_before = window.n_renders();
+                const double event_time = seconds_for( [&]{ window.handle( e ); } );
+                if( window.n_renders() != n_renders_before ) {
+                    render_time += event_time;  max_render_time = max( max_render_time, event_time );
+                }
+            }
+            const Nat n_renders = window.n_renders();
+            const bool is_correct = (
+                n_delivered_sizes + source.n_coalesced() == n_sizes
+                and n_renders <= n_delivered_sizes
+                and source.screen() == expected
+                );
+            ok = ok and is_correct;
+
+            cout << "Live resize to " << final_size.cx << "×" << final_size.cy << " in real time: "
+                 << n_sizes << " size events, " << source.n_coalesced() << " coalesced, "
+                 << n_renders << " renders at " << 1e3*render_time/max( 1, n_renders ) << " ms average and "
+                 << 1e3*max_render_time << " ms max"
+                 << (is_correct? "" : ", BUT THE RESULT IS WRONG") << ".\n";
+            return ok;
+        }
+    }  // checks
+
+
+    // Paints one frame to “parabola.ppm” in the directory for temporary files, then reports
+    // painting speeds and checks the results. With the option
+    // `--large` the recorded series are 10⁸ instead of 10⁷ samples, which takes about a minute and
+    // 1.5 GB of memory. With the option `--large-files` it instead reports rendering from
+    // memory-mapped 1 GB and 10 GB files.
+    auto run( in_<vector<string>> args )
+        -> Process_exit_code
+    {
+        using namespace checks;
+
+        if( args == vector<string>{ "--large-files" } ) {
+            return (report_on_large_mapped_series()? Process_exit_code::success : Process_exit_code::failure);
+        }
+        const size_t n_series_samples = (args == vector<string>{ "--large" }? 100'000'000 : 10'000'000);
+
+        auto framebuffer = painted_frame( default_size );
+        const auto image_path = files::temp_file_path( "parabola.ppm" );
+        if( not graphics::save_as_ppm( framebuffer, image_path.string() ) ) {
+            return Process_exit_code::failure;
+        }
+        cout << "Saved a frame as “" << image_path.string() << "”.\n";
+
+        auto surface = Framebuffer_surface( framebuffer );
+        const double frame_time = seconds_per_call_of( [&]{
+            framebuffer.fill( orange );
+            Painter( surface, default_size ).paint();
+        } );
+        cout << 1/frame_time << " frames per second at "
+             << default_size.cx << "×" << default_size.cy << ".\n";
+
+        bool ok = (
+            report_on( "Resizing", resize_sequence() )
+            and report_on( "Exposing", expose_sequence() )
+            and report_on_parallel_export()
+            );
+        report_on_function_plotters();
+        ok = report_on_forward_differencing() and ok;
+        ok = report_on_fixed_point_transform() and ok;
+        ok = report_on_batch_transform() and ok;
+        ok = report_on_axis_dispatch() and ok;
+        ok = report_on_clipping() and ok;
+        ok = report_on_axis_aligned_lines() and ok;
+        ok = report_on_batched_primitives() and ok;
+        ok = report_on_m4_decimation( n_series_samples ) and ok;
+        ok = report_on_mapped_series() and ok;
+        ok = report_on_lod_pyramid( n_series_samples ) and ok;
+        ok = report_on_event_dispatch() and ok;
+        ok = report_on_live_resize() and ok;
+        return (ok? Process_exit_code::success : Process_exit_code::failure);
+    }
+}  // app
+
+auto main( const int n_args, char** const args ) -> int { return app::run( {args + 1, args + n_args} ); }
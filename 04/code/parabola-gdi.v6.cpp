@@ -0,0 +1,2527 @@
+﻿// With `_WIN32` defined this is the Windows GUI program that paints via GDI. Otherwise it’s the
+// painting code for an in-memory framebuffer, which “parabola-gdi.v6-checks.cpp” measures and
+// checks headless, e.g. in Linux.
+#ifdef _WIN32
+#   ifndef UNICODE
+#       error "Please define UNICODE in the build (this is a wide function based program)."
+#       include <terminate-compilation>     // Workaround for “must continue anyway!” g++.
+#   endif
+#   define NOMINMAX             // No `min` and `max` macros, they break e.g. `std::numeric_limits<Nat>::max()`.
+#   include <windows.h>
+#else
+    // Stand-ins for the `<windows.h>` types used by the painting code.
+    struct POINT{ int x; int y; };
+    struct SIZE{ int cx; int cy; };
+    struct RECT{ int left; int top; int right; int bottom; };
+
+#   include <fcntl.h>           // open
+#   include <sys/mman.h>        // mmap, munmap
+#   include <sys/stat.h>        // fstat
+#   include <unistd.h>          // close
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <initializer_list> // Formally required for initializer-list in range based `for`.
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cassert>          // assert
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>          // EXIT_FAILURE, abs
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#   define HAS_SSE2
+#   include <emmintrin.h>       // SSE2 intrinsics.
+#endif
+
+namespace cppm {                // "C++ machinery"
+    using   std::size;          // <iterator>
+
+    using Nat = int;
+    using C_str = const char*;
+
+    enum Process_exit_code: int { success = 0, failure = EXIT_FAILURE };
+
+    template< class T > using in_ = const T&;       // Type of in-parameters.
+
+    struct Sign{ enum Enum: int { negative = -1, zero = 0, positive = +1 }; };
+
+    template< class T >
+    constexpr auto sign_of( in_<T> v ) noexcept
+        -> Sign::Enum
+    { return Sign::Enum( (v > 0) - (v < 0) ); }
+}  // cppm
+
+namespace threading {
+    using   cppm::Nat, cppm::in_;
+
+    using   std::mutex, std::lock_guard,    // <mutex>
+            std::thread,                    // <thread>
+            std::vector;                    // <vector>
+
+    // Calls `f( i )` for every i in [0, n), on `n_threads` threads. Each thread has a share of
+    // the indices that it takes from the front of. When it has no more it steals from the back
+    // of another thread’s share, so that uneven work gets evened out.
+    template< class Func >
+    void for_each_index_in_parallel( const Nat n, const Nat n_threads, in_<Func> f )
+    {
+        struct Share{ mutex access; Nat i_first; Nat i_beyond; };
+
+        auto shares = vector<Share>( n_threads );
+        for( Nat i = 0; i < n_threads; ++i ) {
+            shares[i].i_first = Nat( 1LL*n*i/n_threads );
+            shares[i].i_beyond = Nat( 1LL*n*(i + 1)/n_threads );
+        }
+
+        const auto work = [&]( const Nat i_thread )
+        {
+            for( ;; ) {
+                Nat i_item = -1;
+                for( Nat k = 0; k < n_threads and i_item < 0; ++k ) {
+                    Share& share = shares[(i_thread + k) % n_threads];
+                    const auto lock = lock_guard<mutex>( share.access );
+                    if( share.i_first < share.i_beyond ) {
+                        i_item = (k == 0? share.i_first++ : --share.i_beyond);
+                    }
+                }
+                if( i_item < 0 ) { return; }
+                f( i_item );
+            }
+        };
+
+        vector<thread> helpers;
+        for( Nat i = 1; i < n_threads; ++i ) { helpers.emplace_back( work, i ); }
+        work( 0 );
+        for( thread& t: helpers ) { t.join(); }
+    }
+}  // threading
+
+namespace geometry{
+    using   cppm::in_;
+
+    struct Handedness{ enum Enum: int { like_math, opposite_math }; };
+
+    // Template parameter `Point` should be like `struct Point{ int x; int y; }`.
+    template< class Point, Handedness::Enum handedness = Handedness::like_math >
+    class Point_vector_
+    {
+        Point   m_pt;
+
+        friend auto math_rotl( in_<Point_vector_> vec )
+            -> Point_vector_
+        { return {-vec.y(), vec.x()}; }
+
+        friend auto math_rotr( in_<Point_vector_> vec )
+            -> Point_vector_
+        { return {vec.y(), -vec.x()}; }
+
+    public:
+        Point_vector_(): m_pt() {}
+        Point_vector_( in_<Point> pt ): m_pt( pt ) {}
+        Point_vector_( const int x, const int y ): m_pt{ x, y } {}
+
+        auto x() const -> int { return m_pt.x; }
+        auto y() const -> int { return m_pt.y; }
+
+        operator Point () const { return m_pt; }
+
+        friend auto operator*( const int n, in_<Point_vector_> vec )
+            -> Point_vector_
+        { return {n*vec.x(), n*vec.y()}; }
+
+        friend auto operator+( in_<Point> pt, in_<Point_vector_> vec )
+            -> Point
+        { return {pt.x + vec.x(), pt.y + vec.y()}; }
+
+        friend auto operator-( in_<Point> pt, in_<Point_vector_> vec )
+            -> Point
+        { return {pt.x - vec.x(), pt.y - vec.y()}; }
+
+        friend auto rotl( in_<Point_vector_> vec )
+            -> Point_vector_
+        { return (handedness == Handedness::like_math? math_rotl( vec ) : math_rotr( vec )); }
+
+        friend auto rotr( in_<Point_vector_> vec )
+            -> Point_vector_
+        { return (handedness == Handedness::like_math? math_rotr( vec ) : math_rotl( vec )); }
+    };
+}  // geometry
+
+namespace numerics {
+    using   cppm::Nat, cppm::in_;
+
+    using   std::min,                   // <algorithm>
+            std::numeric_limits,        // <limits>
+            std::move,                  // <utility>
+            std::vector;                // <vector>
+
+    using   std::abs;                   // <cmath>
+
+    // c[0] + c[1]·x + … + c[d]·x^d, evaluated with Horner’s rule.
+    class Polynomial
+    {
+        vector<double>  m_coefficients;
+
+    public:
+        explicit Polynomial( vector<double> coefficients ):
+            m_coefficients( move( coefficients ) )
+        {
+            assert( not m_coefficients.empty() );
+        }
+
+        auto degree() const -> Nat { return Nat( m_coefficients.size() ) - 1; }
+        auto coefficients() const -> const vector<double>& { return m_coefficients; }
+
+        auto operator()( const double x ) const
+            -> double
+        {
+            double result = m_coefficients.back();
+            for( Nat j = degree() - 1; j >= 0; --j ) { result = result*x + m_coefficients[j]; }
+            return result;
+        }
+
+        // A bound on the rounding error of `operator()` at `x`, including the effect of `x`
+        // itself being off by a rounding, in terms of the standard Horner error bound.
+        auto error_bound_at( const double x ) const
+            -> double
+        {
+            double sum_of_magnitudes = 0;
+            for( Nat j = degree(); j >= 0; --j ) {
+                sum_of_magnitudes = sum_of_magnitudes*abs( x ) + abs( m_coefficients[j] );
+            }
+            return (3*degree() + 1)*numeric_limits<double>::epsilon()*sum_of_magnitudes;
+        }
+    };
+
+    // The values p(x0), p(x0 + h), p(x0 + 2h), … of a polynomial p of degree d, at a cost of d
+    // additions per value. The forward differences at x0 are computed from the coefficients of p
+    // shifted to x0, not by subtracting values, which would lose most of the precision.
+    //
+    // The values are produced in groups of `n_lanes` consecutive values, by as many independent
+    // sequences with step `n_lanes`·h. A single sequence would be limited by the latency of
+    // each addition depending on the previous step, instead of by the number of additions.
+    class Forward_differences
+    {
+    public:
+        static constexpr Nat n_lanes = 4;
+
+    private:
+        Nat             m_degree;
+        double          m_h;
+        vector<double>  m_coefficients;
+        vector<double>  m_k_factorial_stirling2;    // k!·S(j, k), the k-th difference of t^j at 0.
+        vector<double>  m_lanes_step_weights;       // Of Δᵐ in Δₙᵏ, where Δₙ is Δ with step n·h.
+        vector<double>  m_shifted;
+        vector<double>  m_differences;              // Δ⁰p, Δ¹p, … Δᵈp at x0.
+        vector<double>  m_lanes;                    // Δₙᵏp at x0 + i·h, at [k*n_lanes + i].
+
+        auto u( const Nat j, const Nat k ) -> double& { return m_k_factorial_stirling2[j*(m_degree + 1) + k]; }
+        auto w( const Nat k, const Nat m ) -> double& { return m_lanes_step_weights[k*(m_degree + 1) + m]; }
+
+    public:
+        Forward_differences( in_<Polynomial> p, const double h ):
+            m_degree( p.degree() ),
+            m_h( h ),
+            m_coefficients( p.coefficients() ),
+            m_k_factorial_stirling2( (m_degree + 1)*(m_degree + 1), 0.0 ),
+            m_lanes_step_weights( (m_degree + 1)*(m_degree + 1), 0.0 ),
+            m_shifted( m_degree + 1 ),
+            m_differences( m_degree + 1 ),
+            m_lanes( (m_degree + 1)*n_lanes )
+        {
+            const Nat d = m_degree;
+
+            // From S(j, k) = k·S(j - 1, k) + S(j - 1, k - 1).
+            u( 0, 0 ) = 1;
+            for( Nat j = 1; j <= d; ++j ) {
+                for( Nat k = 1; k <= j; ++k ) { u( j, k ) = k*(u( j - 1, k ) + u( j - 1, k - 1 )); }
+            }
+
+            // Δₙ = (1 + Δ)ⁿ - 1, so Δₙᵏ is the k-th power of that polynomial in Δ, up to Δᵈ.
+            vector<double> step_n( d + 1, 0.0 );
+            double binomial = 1;
+            for( Nat m = 1; m <= min( d, n_lanes ); ++m ) {
+                binomial = binomial*(n_lanes - m + 1)/m;
+                step_n[m] = binomial;
+            }
+            w( 0, 0 ) = 1;
+            for( Nat k = 1; k <= d; ++k ) {
+                for( Nat m = k; m <= d; ++m ) {
+                    for( Nat i = 1; i <= m - (k - 1); ++i ) { w( k, m ) += step_n[i]*w( k - 1, m - i ); }
+                }
+            }
+        }
+
+        auto degree() const -> Nat { return m_degree; }
+
+        // Afterwards `lane_value( i )` is p(x0 + i·h).
+        void anchor_at( const double x0 )
+        {
+            // Coefficients of p(x0 + t·h) in t, by repeated synthetic division.
+            const Nat d = m_degree;
+            m_shifted = m_coefficients;
+            for( Nat i = 0; i < d; ++i ) {
+                for( Nat j = d - 1; j >= i; --j ) { m_shifted[j] += x0*m_shifted[j + 1]; }
+            }
+            double h_power = 1;
+            for( Nat j = 0; j <= d; ++j ) { m_shifted[j] *= h_power;  h_power *= m_h; }
+
+            for( Nat k = 0; k <= d; ++k ) {
+                double sum = 0;
+                for( Nat j = d; j >= k; --j ) { sum += u( j, k )*m_shifted[j]; }
+                m_differences[k] = sum;
+            }
+
+            // Each lane starts a step after the previous one, and steps n_lanes·h.
+            for( Nat i = 0; i < n_lanes; ++i ) {
+                for( Nat k = 0; k <= d; ++k ) {
+                    double sum = 0;
+                    for( Nat m = d; m >= k; --m ) { sum += w( k, m )*m_differences[m]; }
+                    m_lanes[k*n_lanes + i] = sum;
+                }
+                for( Nat k = 0; k < d; ++k ) { m_differences[k] += m_differences[k + 1]; }
+            }
+        }
+
+        auto lane_value( const Nat i ) const -> double { return m_lanes[i]; }
+
+        // Stores the current lane values as `values[0]` through `values[n_lanes - 1]`, and
+        // advances each lane by n_lanes·h, `n_groups` times. With SSE2 the four lanes are two
+        // register pairs, and each difference is loaded once per step; the compiler doesn’t
+        // vectorize the scalar version because the lanes are updated in place.
+        void produce( double* const values, const Nat n_groups )
+        {
+            double* const lanes = m_lanes.data();
+            const Nat d = m_degree;
+            for( Nat g = 0; g < n_groups; ++g ) {
+                double* const group_values = values + g*n_lanes;
+            #ifdef HAS_SSE2
+                static_assert( n_lanes == 4 );
+                __m128d low     = _mm_loadu_pd( lanes );
+                __m128d high    = _mm_loadu_pd( lanes + 2 );
+                _mm_storeu_pd( group_values, low );
+                _mm_storeu_pd( group_values + 2, high );
+                for( Nat k = 0; k < d; ++k ) {
+                    const __m128d next_low  = _mm_loadu_pd( lanes + (k + 1)*n_lanes );
+                    const __m128d next_high = _mm_loadu_pd( lanes + (k + 1)*n_lanes + 2 );
+                    _mm_storeu_pd( lanes + k*n_lanes, _mm_add_pd( low, next_low ) );
+                    _mm_storeu_pd( lanes + k*n_lanes + 2, _mm_add_pd( high, next_high ) );
+                    low = next_low;  high = next_high;
+                }
+            #else
+                for( Nat i = 0; i < n_lanes; ++i ) { group_values[i] = lanes[i]; }
+                for( Nat k = 0; k < d; ++k ) {
+                    for( Nat i = 0; i < n_lanes; ++i ) { lanes[k*n_lanes + i] += lanes[(k + 1)*n_lanes + i]; }
+                }
+            #endif
+            }
+        }
+    };
+}  // numerics
+
+namespace graphics {
+    using   cppm::Nat, cppm::in_, cppm::sign_of;
+
+    using   std::copy, std::max, std::min,     // <algorithm>
+            std::ofstream,              // <fstream>
+            std::string,                // <string>
+            std::move,                  // <utility>
+            std::vector;                // <vector>
+
+    using   std::size_t,                // <cstddef>
+            std::int64_t, std::uint32_t, std::uint64_t,     // <cstdint>
+            std::abs;                   // <cstdlib>
+
+    class Primitive_batch;
+
+    // The drawing primitives used by the painting code, with GDI’s pixel semantics: a polyline
+    // doesn’t include its last point, and a rectangle doesn’t include its right and bottom edges.
+    // Drawing is in black.
+    class Surface
+    {
+    public:
+        virtual ~Surface() {}
+
+        virtual void polyline( const POINT* points, Nat n ) = 0;
+        virtual void fill_rect( in_<RECT> r ) = 0;
+
+        // Batches, by default drawn one by one. The polylines are consecutive in `points`, with
+        // `counts[i]` points in polyline i, like with GDI’s `PolyPolyline`.
+
+        virtual void poly_polyline( const POINT* points, const Nat* const counts, const Nat n_polylines )
+        {
+            for( Nat i = 0; i < n_polylines; ++i ) {
+                polyline( points, counts[i] );
+                points += counts[i];
+            }
+        }
+
+        virtual void fill_rects( const RECT* const rects, const Nat n )
+        {
+            for( Nat i = 0; i < n; ++i ) { fill_rect( rects[i] ); }
+        }
+
+        // A surface where each call is costly, such as a GDI DC, offers a batch to collect a
+        // frame’s primitives in, for drawing them with one call per kind. Others draw directly.
+        virtual auto batch() -> Primitive_batch* { return nullptr; }
+    };
+
+    void draw_line_sans_endpoint( Surface& surface, in_<POINT> from, in_<POINT> to )
+    {
+        const POINT points[] = {from, to};
+        surface.polyline( points, 2 );
+    }
+
+    void set_px( Surface& surface, in_<POINT> where )
+    {
+        // With a fancy pen this can conceivably be imperfect.
+        draw_line_sans_endpoint( surface, where, {where.x + 1, where.y} );
+    }
+
+    void draw_line( Surface& surface, in_<POINT> from, in_<POINT> to )
+    {
+        if( from.x == to.x or from.y == to.y ) {
+            // One call: extending an axis-aligned line by 1 pixel includes the endpoint exactly.
+            const bool is_point = (from.x == to.x and from.y == to.y);
+            const POINT beyond = (is_point
+                ? POINT{ to.x + 1, to.y }
+                : POINT{ to.x + sign_of( to.x - from.x ), to.y + sign_of( to.y - from.y ) }
+                );
+            draw_line_sans_endpoint( surface, from, beyond );
+        } else {
+            draw_line_sans_endpoint( surface, from, to );
+            set_px( surface, to );
+        }
+    }
+
+    // Accumulates the primitives drawn on it by kind, for submission with one call per kind. All
+    // drawing is in black, so the order between kinds doesn’t matter.
+    class Primitive_batch: public Surface
+    {
+        vector<POINT>   m_points;
+        vector<Nat>     m_counts;
+        vector<RECT>    m_rects;
+
+    public:
+        void polyline( const POINT* points, const Nat n ) override
+        {
+            if( n < 2 ) { return; }         // No pixels, and `PolyPolyline` would fail.
+            m_points.insert( m_points.end(), points, points + n );
+            m_counts.push_back( n );
+        }
+
+        void fill_rect( in_<RECT> r ) override { m_rects.push_back( r ); }
+
+        // Keeps the buffers, so that a reused batch doesn’t allocate.
+        void clear()
+        {
+            m_points.clear();  m_counts.clear();  m_rects.clear();
+        }
+
+        void submit_to( Surface& target ) const
+        {
+            if( not m_counts.empty() ) {
+                target.poly_polyline( m_points.data(), m_counts.data(), Nat( m_counts.size() ) );
+            }
+            if( not m_rects.empty() ) {
+                target.fill_rects( m_rects.data(), Nat( m_rects.size() ) );
+            }
+        }
+    };
+
+    // A 32-bit RGBA color with the bytes in that order in memory, on a little-endian machine.
+    using Rgba = uint32_t;
+
+    constexpr auto rgba( const Nat r, const Nat g, const Nat b, const Nat a = 0xFF )
+        -> Rgba
+    { return Rgba( r | (g << 8) | (b << 16) ) | (Rgba( a ) << 24); }
+
+    auto intersection_of( in_<RECT> a, in_<RECT> b )
+        -> RECT
+    {
+        return {
+            max( a.left, b.left ), max( a.top, b.top ), min( a.right, b.right ), min( a.bottom, b.bottom )
+            };
+    }
+
+    auto is_empty( in_<RECT> r ) -> bool { return r.left >= r.right or r.top >= r.bottom; }
+
+    // GDI in Windows NT limits coordinates to 27 bits, i.e. ±2²⁶, so the clipping cuts segments
+    // at a guard limit within that.
+    constexpr Nat clipping_guard_limit = 1 << 25;
+
+    // Calls `f( points, n )` for each run of the polyline that can have pixels in `r`. A run ends
+    // where a segment is entirely outside one side of `r` plus a 1 pixel wide border, found via
+    // Cohen–Sutherland outcodes, so that the excluded last point of a run is outside `r`. The
+    // runs have the original points, so their pixels in `r` are exactly those of the polyline.
+    // The exception is a point beyond ±`clipping_guard_limit`, which ends a run and starts the
+    // next, and is replaced by the ends of its segments cut with Liang–Barsky.
+    template< class Func >
+    void for_each_clipped_run( const POINT* const points, const Nat n, in_<RECT> r, Func&& f )
+    {
+        const RECT box = {r.left - 1, r.top - 1, r.right, r.bottom};    // Inclusive bounds.
+        const auto outcode_of = [&]( in_<POINT> p ) -> int {
+            return (p.x < box.left) | (p.x > box.right) << 1 | (p.y < box.top) << 2 | (p.y > box.bottom) << 3;
+        };
+        const auto is_beyond_guard = []( in_<POINT> p ) -> bool {
+            const Nat limit = clipping_guard_limit;
+            return (p.x < -limit or p.x > limit or p.y < -limit or p.y > limit);
+        };
+
+        // Liang–Barsky: the parameter range [t_entry, t_exit] of the part of the segment from `a`
+        // to `b` within the guard limits, in `double` because `int` differences can overflow.
+        struct Cut{ double t_entry; double t_exit; POINT entry; POINT exit; };
+        const auto guard_cut_of = []( in_<POINT> a, in_<POINT> b ) -> Cut {
+            const double limit = clipping_guard_limit;
+            const double dx = 1.0*b.x - a.x;
+            const double dy = 1.0*b.y - a.y;
+            double t_entry = 0;  double t_exit = 1;
+            const auto clip = [&]( const double p, const double q ) {
+                if( p == 0 ) {
+                    if( q < 0 ) { t_entry = 2; }            // Parallel and outside.
+                } else if( p < 0 ) {
+                    t_entry = max( t_entry, q/p );
+                } else {
+                    t_exit = min( t_exit, q/p );
+                }
+            };
+            clip( -dx, a.x + limit );  clip( dx, limit - a.x );
+            clip( -dy, a.y + limit );  clip( dy, limit - a.y );
+            const auto point_at = [&]( const double t ) -> POINT {
+                return {int( std::lround( a.x + t*dx ) ), int( std::lround( a.y + t*dy ) )};
+            };
+            return (t_entry > t_exit? Cut{t_entry, t_exit, a, b} : Cut{t_entry, t_exit, point_at( t_entry ), point_at( t_exit )});
+        };
+
+        thread_local vector<POINT> cut_run;     // Reused from call to call.
+        const auto call_f_for_run = [&]( const Nat i_first, const Nat i_last ) {
+            if( i_last <= i_first ) { return; }
+            const bool is_start_cut = is_beyond_guard( points[i_first] );
+            const bool is_end_cut = is_beyond_guard( points[i_last] );
+            if( not (is_start_cut or is_end_cut) ) {
+                f( points + i_first, i_last + 1 - i_first );
+                return;
+            }
+            cut_run.assign( points + i_first, points + i_last + 1 );
+            if( is_start_cut ) { cut_run.front() = guard_cut_of( points[i_first], points[i_first + 1] ).entry; }
+            if( is_end_cut ) { cut_run.back() = guard_cut_of( points[i_last - 1], points[i_last] ).exit; }
+            f( cut_run.data(), Nat( cut_run.size() ) );
+        };
+
+        constexpr Nat no_run = -1;
+        Nat i_run_start = no_run;
+        int a_outcode = (n > 0? outcode_of( points[0] ) : 0);
+        for( Nat i = 1; i < n; ++i ) {
+            const POINT& a = points[i - 1];  const POINT& b = points[i];
+            const int b_outcode = outcode_of( b );
+            bool is_outside = ((a_outcode & b_outcode) != 0);      // Entirely outside one side.
+            const bool is_beyond = (b_outcode != 0 and is_beyond_guard( b ));
+            if( not is_outside and (is_beyond or (a_outcode != 0 and is_beyond_guard( a ))) ) {
+                const Cut cut = guard_cut_of( a, b );
+                is_outside = (cut.t_entry > cut.t_exit);            // Passes outside the guard limits.
+            }
+            a_outcode = b_outcode;
+
+            if( is_outside ) {
+                if( i_run_start != no_run ) { call_f_for_run( i_run_start, i - 1 );  i_run_start = no_run; }
+                continue;
+            }
+            if( i_run_start == no_run ) { i_run_start = i - 1; }
+            if( is_beyond ) {
+                call_f_for_run( i_run_start, i );
+                i_run_start = i;
+            }
+        }
+        if( i_run_start != no_run ) { call_f_for_run( i_run_start, n - 1 ); }
+    }
+
+    // The parts of the polyline within `r`, drawn as one or more polylines.
+    void draw_clipped_polyline( Surface& surface, const POINT* const points, const Nat n, in_<RECT> r )
+    {
+        for_each_clipped_run( points, n, r,
+            [&]( const POINT* run_points, const Nat n_run_points ) { surface.polyline( run_points, n_run_points ); }
+            );
+    }
+
+    // The smallest rectangle with all pixels of a line from `a` to `b`.
+    auto bounds_of_line( in_<POINT> a, in_<POINT> b )
+        -> RECT
+    { return {min( a.x, b.x ), min( a.y, b.y ), max( a.x, b.x ) + 1, max( a.y, b.y ) + 1}; }
+
+    class Rgba_framebuffer
+    {
+        Nat             m_w;
+        Nat             m_h;
+        vector<Rgba>    m_pixels;       // Row by row from the top, like a GDI DIB section.
+
+    public:
+        Rgba_framebuffer( in_<SIZE> size, const Rgba color ):
+            m_w( size.cx ),
+            m_h( size.cy ),
+            m_pixels( size_t( m_w )*m_h, color )
+        {
+            assert( m_w >= 0 );
+            assert( m_h >= 0 );
+        }
+
+        auto w() const -> Nat { return m_w; }
+        auto h() const -> Nat { return m_h; }
+        auto bounds() const -> RECT { return {0, 0, m_w, m_h}; }
+
+        auto px( const Nat x, const Nat y ) const -> Rgba { return m_pixels[size_t( y )*m_w + x]; }
+
+        auto operator==( in_<Rgba_framebuffer> other ) const
+            -> bool
+        { return m_w == other.m_w and m_h == other.m_h and m_pixels == other.m_pixels; }
+
+        void fill( const Rgba color ) { m_pixels.assign( m_pixels.size(), color ); }
+
+        // Copies the pixels within `r` from the same place in `other`, like GDI’s `BitBlt`.
+        void copy_rect_from( in_<Rgba_framebuffer> other, in_<RECT> r )
+        {
+            const RECT area = intersection_of( intersection_of( r, bounds() ), other.bounds() );
+            for( Nat y = area.top; y < area.bottom; ++y ) {
+                const auto p_source = other.m_pixels.begin() + size_t( y )*other.m_w;
+                copy( p_source + area.left, p_source + area.right, m_pixels.begin() + size_t( y )*m_w + area.left );
+            }
+        }
+
+        // The drawing operations only change pixels within `clip`, which must be within the buffer.
+
+        void set_px( const Nat x, const Nat y, const Rgba color, in_<RECT> clip )
+        {
+            if( clip.left <= x and x < clip.right and clip.top <= y and y < clip.bottom ) {
+                m_pixels[size_t( y )*m_w + x] = color;
+            }
+        }
+
+        // Horizontal and vertical lines are filled as spans, with the same pixels as Bresenham’s.
+        // Any `int` coordinates are safe.
+        void draw_line_sans_endpoint( in_<POINT> from, in_<POINT> to, const Rgba color, in_<RECT> clip )
+        {
+            if( from.y == to.y and from.x != to.x ) {
+                const int x_first = (from.x < to.x? from.x : to.x + 1);
+                const int x_beyond = (from.x < to.x? to.x : Nat( min<int64_t>( from.x + int64_t( 1 ), clip.right ) ));
+                fill_row_span( from.y, x_first, x_beyond, color, clip );
+            } else if( from.x == to.x and from.y != to.y ) {
+                const int y_first = (from.y < to.y? from.y : to.y + 1);
+                const int y_beyond = (from.y < to.y? to.y : Nat( min<int64_t>( from.y + int64_t( 1 ), clip.bottom ) ));
+                fill_column_span( from.x, y_first, y_beyond, color, clip );
+            } else {
+                draw_bresenham_line_sans_endpoint( from, to, color, clip );
+            }
+        }
+
+        // Pixels [x_first, x_beyond) of row y.
+        void fill_row_span( const Nat y, const Nat x_first, const Nat x_beyond, const Rgba color, in_<RECT> clip )
+        {
+            if( y < clip.top or y >= clip.bottom ) { return; }
+            const Nat x_start = max( x_first, Nat( clip.left ) );
+            const Nat x_end = min( x_beyond, Nat( clip.right ) );
+            if( x_start >= x_end ) { return; }
+            const auto p_row = m_pixels.begin() + size_t( y )*m_w;
+            std::fill( p_row + x_start, p_row + x_end, color );       // Not the member `fill`.
+        }
+
+        // Pixels [y_first, y_beyond) of column x.
+        void fill_column_span( const Nat x, const Nat y_first, const Nat y_beyond, const Rgba color, in_<RECT> clip )
+        {
+            if( x < clip.left or x >= clip.right ) { return; }
+            const Nat y_start = max( y_first, Nat( clip.top ) );
+            const Nat y_end = min( y_beyond, Nat( clip.bottom ) );
+            if( y_start >= y_end ) { return; }
+            Rgba* p = m_pixels.data() + size_t( y_start )*m_w + x;
+            for( Nat y = y_start; y < y_end; ++y, p += m_w ) { *p = color; }
+        }
+
+        // Bresenham’s algorithm. The pixels don’t depend on the clip rectangle, but only the steps
+        // within its extent along the major axis are taken. Every step moves along the major axis,
+        // and after k steps the number of minor axis steps is round( k·minor/major ), with halves
+        // rounded up, which gives the start state directly. In 64 bits, so that any `int`
+        // coordinates are safe.
+        void draw_bresenham_line_sans_endpoint( in_<POINT> from, in_<POINT> to, const Rgba color, in_<RECT> clip )
+        {
+            const int64_t dx = abs( int64_t( to.x ) - from.x );
+            const int64_t dy = -abs( int64_t( to.y ) - from.y );
+            const int x_step = (from.x < to.x? +1 : -1);
+            const int y_step = (from.y < to.y? +1 : -1);
+
+            const bool      is_x_major  = (dx >= -dy);
+            const int64_t   n_major     = (is_x_major? dx : -dy);
+            const int64_t   n_minor     = (is_x_major? -dy : dx);
+            const int64_t   start       = (is_x_major? from.x : from.y);
+            const int       step        = (is_x_major? x_step : y_step);
+            const int64_t   lo          = (is_x_major? clip.left : clip.top);
+            const int64_t   hi          = (is_x_major? clip.right : clip.bottom);
+
+            const int64_t k_first = max<int64_t>( 0, step > 0? lo - start : start - (hi - 1) );
+            const int64_t k_beyond = min<int64_t>( n_major, step > 0? hi - start : start - lo + 1 );
+            if( k_first >= k_beyond ) { return; }
+
+            // Both factors are less than 2³², so the product fits, and the error is computed from
+            // the remainder so that no term overflows.
+            const uint64_t  product     = uint64_t( k_first )*uint64_t( n_minor );
+            const auto      q           = int64_t( product/uint64_t( n_major ) );
+            const auto      r           = int64_t( product%uint64_t( n_major ) );
+            const int64_t   m_extra     = (2*r + n_major)/(2*n_major);      // 0 or 1.
+            const int64_t   m_first     = q + m_extra;
+
+            int64_t x = from.x + int64_t( x_step )*(is_x_major? k_first : m_first);
+            int64_t y = from.y + int64_t( y_step )*(is_x_major? m_first : k_first);
+            int64_t error = dx + dy + (is_x_major? m_extra*dx - r : m_extra*dy + r);
+            for( int64_t k = k_first; k < k_beyond; ++k ) {
+                set_px( Nat( x ), Nat( y ), color, clip );
+                const int64_t e2 = 2*error;
+                if( e2 >= dy ) { error += dy; x += x_step; }
+                if( e2 <= dx ) { error += dx; y += y_step; }
+            }
+        }
+
+        void fill_rect( in_<RECT> r, const Rgba color, in_<RECT> clip )
+        {
+            const RECT area = intersection_of( r, clip );
+            if( is_empty( area ) ) { return; }
+            for( Nat y = area.top; y < area.bottom; ++y ) {
+                const auto p_row = m_pixels.begin() + size_t( y )*m_w;
+                std::fill( p_row + area.left, p_row + area.right, color );     // Not the member `fill`.
+            }
+        }
+    };
+
+    class Framebuffer_surface: public Surface
+    {
+        Rgba_framebuffer&   m_framebuffer;
+        RECT                m_clip;
+        Rgba                m_ink   = rgba( 0, 0, 0 );
+
+    public:
+        Framebuffer_surface( Rgba_framebuffer& fb ): Framebuffer_surface( fb, fb.bounds() ) {}
+
+        Framebuffer_surface( Rgba_framebuffer& fb, in_<RECT> clip ):
+            m_framebuffer( fb ),
+            m_clip( intersection_of( clip, fb.bounds() ) )
+        {}
+
+        void polyline( const POINT* points, const Nat n ) override
+        {
+            for( Nat i = 1; i < n; ++i ) {
+                m_framebuffer.draw_line_sans_endpoint( points[i - 1], points[i], m_ink, m_clip );
+            }
+        }
+
+        void fill_rect( in_<RECT> r ) override { m_framebuffer.fill_rect( r, m_ink, m_clip ); }
+
+        void poly_polyline( const POINT* points, const Nat* const counts, const Nat n_polylines ) override
+        {
+            for( Nat i_polyline = 0; i_polyline < n_polylines; ++i_polyline ) {
+                for( Nat i = 1; i < counts[i_polyline]; ++i ) {
+                    m_framebuffer.draw_line_sans_endpoint( points[i - 1], points[i], m_ink, m_clip );
+                }
+                points += counts[i_polyline];
+            }
+        }
+
+        void fill_rects( const RECT* const rects, const Nat n ) override
+        {
+            for( Nat i = 0; i < n; ++i ) { m_framebuffer.fill_rect( rects[i], m_ink, m_clip ); }
+        }
+    };
+
+    // Records the primitives drawn on it, so that they can be replayed within any region, and
+    // so that changes can be detected via hash values of the parts within each region.
+    class Display_list: public Surface
+    {
+        struct Primitive{ bool is_rect; RECT rect; Nat i_first_point; Nat n_points; };
+
+        vector<Primitive>   m_primitives;
+        vector<POINT>       m_points;
+
+        static constexpr auto hash_of( const int a, const int b, const int c, const int d )
+            -> uint64_t
+        {
+            uint64_t hash = initial_hash;
+            for( const int v: {a, b, c, d} ) { hash = hash_combine( hash, uint32_t( v ) ); }
+            return hash;
+        }
+
+    public:
+        // 64-bit FNV-1a, but a word at a time.
+        static constexpr uint64_t initial_hash = 0xCBF2'9CE4'8422'2325;
+
+        static constexpr auto hash_combine( const uint64_t hash, const uint64_t v )
+            -> uint64_t
+        { return (hash ^ v)*0x0000'0100'0000'01B3; }
+
+        void clear() { m_primitives.clear();  m_points.clear(); }
+
+        void polyline( const POINT* points, const Nat n ) override
+        {
+            m_primitives.push_back( {false, {}, Nat( m_points.size() ), n} );
+            m_points.insert( m_points.end(), points, points + n );
+        }
+
+        void fill_rect( in_<RECT> r ) override { m_primitives.push_back( {true, r, 0, 0} ); }
+
+        // A rectangle, or a line segment starting at point `i_point`.
+        struct Part{ Nat i_primitive; Nat i_point; };
+
+        void draw( in_<Part> part, Surface& target ) const
+        {
+            const Primitive& primitive = m_primitives[part.i_primitive];
+            if( primitive.is_rect ) {
+                target.fill_rect( primitive.rect );
+            } else {
+                target.polyline( &m_points[part.i_point], 2 );
+            }
+        }
+
+        // Calls `f( bounds, hash, part )` for each rectangle and line segment, in drawing order.
+        // A `hash` of 0 says that the part fills its bounds, as a rectangle or an axis-aligned line
+        // does, so that its pixels within any region are given by the intersection with the bounds.
+        template< class Func >
+        void for_each_part( Func&& f ) const
+        {
+            for( Nat i_primitive = 0; i_primitive < Nat( m_primitives.size() ); ++i_primitive ) {
+                const Primitive& primitive = m_primitives[i_primitive];
+                if( primitive.is_rect ) {
+                    f( primitive.rect, uint64_t( 0 ), Part{ i_primitive, 0 } );
+                    continue;
+                }
+                for( Nat i = primitive.i_first_point + 1; i < primitive.i_first_point + primitive.n_points; ++i ) {
+                    const POINT& a = m_points[i - 1];  const POINT& b = m_points[i];
+                    const auto part = Part{ i_primitive, i - 1 };
+                    if( a.x == b.x and a.y == b.y ) { continue; }     // No pixels.
+                    const bool is_axis_aligned = (a.x == b.x or a.y == b.y);
+                    if( is_axis_aligned ) {
+                        // The bounds include the excluded endpoint, so shrink them to exclude it.
+                        const POINT beyond = {
+                            b.x + (a.x < b.x? 0 : a.x > b.x? 1 : 0),
+                            b.y + (a.y < b.y? 0 : a.y > b.y? 1 : 0)
+                            };
+                        const RECT r = {
+                            min( a.x, beyond.x ), min( a.y, beyond.y ),
+                            max( a.x + 1, beyond.x ), max( a.y + 1, beyond.y )
+                            };
+                        if( not is_empty( r ) ) { f( r, uint64_t( 0 ), part ); }
+                    } else {
+                        f( bounds_of_line( a, b ), hash_of( a.x, a.y, b.x, b.y ), part );
+                    }
+                }
+            }
+        }
+
+        // The hash of a rectangle within a region, for parts with hash 0 per `for_each_part`.
+        static constexpr auto hash_of( in_<RECT> r )
+            -> uint64_t
+        { return hash_combine( hash_of( r.left, r.top, r.right, r.bottom ), 1 ); }
+
+        // Draws the parts that intersect `region`. A polyline is a sequence of lines sans
+        // endpoints, so drawing its segments one by one produces the same pixels.
+        void replay_to( Surface& target, in_<RECT> region ) const
+        {
+            for( const Primitive& primitive: m_primitives ) {
+                if( primitive.is_rect ) {
+                    if( not is_empty( intersection_of( primitive.rect, region ) ) ) {
+                        target.fill_rect( primitive.rect );
+                    }
+                    continue;
+                }
+                const POINT* const points = &m_points[primitive.i_first_point];
+                for( Nat i = 1; i < primitive.n_points; ++i ) {
+                    if( not is_empty( intersection_of( bounds_of_line( points[i - 1], points[i] ), region ) ) ) {
+                        target.polyline( &points[i - 1], 2 );
+                    }
+                }
+            }
+        }
+    };
+
+    // A framebuffer divided into tiles that are re-rasterized only when they’re invalidated, or
+    // when the display list parts within them change. A change of size moves the graph, so then
+    // most tiles change anyway: the whole frame is rasterized without hashing, and the hashes
+    // are established again by the first update at an unchanged size.
+    class Tiled_framebuffer
+    {
+    public:
+        static constexpr Nat tile_size = 64;
+
+    private:
+        Rgba_framebuffer    m_pixels;
+        Rgba                m_background;
+        Nat                 m_n_tile_cols;
+        Nat                 m_n_tile_rows;
+        vector<uint64_t>    m_tile_hashes;          // Of the display list parts in each tile.
+        vector<bool>        m_tile_is_valid;        // `false` ⇨ re-rasterize regardless of hash.
+        bool                m_is_resized    = false;    // ⇨ rasterize all, without hashing.
+
+        static auto n_tiles_for( const Nat n_pixels ) -> Nat { return (n_pixels + tile_size - 1)/tile_size; }
+
+        auto tile_rect( const Nat i_tile ) const
+            -> RECT
+        { return tile_rect( i_tile % m_n_tile_cols, i_tile / m_n_tile_cols ); }
+
+        auto tile_rect( const Nat i_col, const Nat i_row ) const
+            -> RECT
+        {
+            const RECT r = {
+                i_col*tile_size, i_row*tile_size, (i_col + 1)*tile_size, (i_row + 1)*tile_size
+                };
+            return intersection_of( r, m_pixels.bounds() );
+        }
+
+        // Calls `f( i_tile )` for each tile that intersects `r`.
+        template< class Func >
+        void for_each_tile_in( in_<RECT> r, Func&& f ) const
+        {
+            const RECT area = intersection_of( r, m_pixels.bounds() );
+            if( is_empty( area ) ) { return; }
+            for( Nat i_row = area.top/tile_size; i_row <= (area.bottom - 1)/tile_size; ++i_row ) {
+                for( Nat i_col = area.left/tile_size; i_col <= (area.right - 1)/tile_size; ++i_col ) {
+                    f( i_row*m_n_tile_cols + i_col );
+                }
+            }
+        }
+
+    public:
+        Tiled_framebuffer( in_<SIZE> size, const Rgba background ):
+            m_pixels( size, background ),
+            m_background( background ),
+            m_n_tile_cols( n_tiles_for( size.cx ) ),
+            m_n_tile_rows( n_tiles_for( size.cy ) ),
+            m_tile_hashes( size_t( m_n_tile_cols )*m_n_tile_rows ),
+            m_tile_is_valid( m_tile_hashes.size(), false )
+        {}
+
+        auto pixels() const -> const Rgba_framebuffer& { return m_pixels; }
+
+        // All tiles are then invalid, and the next update rasterizes the whole frame.
+        void resize( in_<SIZE> new_size )
+        {
+            *this = Tiled_framebuffer( new_size, m_background );
+            m_is_resized = true;
+        }
+
+        void invalidate( in_<RECT> r )
+        {
+            for_each_tile_in( r, [&]( const Nat i_tile ) { m_tile_is_valid[i_tile] = false; } );
+        }
+
+        // Re-rasterizes the tiles that are invalid or have changed content. Returns their number.
+        auto update_from( in_<Display_list> display_list )
+            -> Nat
+        {
+            if( m_is_resized ) {
+                // The tiles stay invalid, since their hashes are unknown.
+                auto surface = Framebuffer_surface( m_pixels );
+                display_list.replay_to( surface, m_pixels.bounds() );
+                m_is_resized = false;
+                return m_n_tile_cols*m_n_tile_rows;
+            }
+
+            vector<uint64_t> new_hashes( m_tile_hashes.size(), Display_list::initial_hash );
+            display_list.for_each_part( [&]( in_<RECT> bounds, const uint64_t part_hash, auto ) {
+                for_each_tile_in( bounds, [&]( const Nat i_tile ) {
+                    const uint64_t hash = (part_hash != 0? part_hash
+                        : Display_list::hash_of( intersection_of( bounds, tile_rect( i_tile ) ) )
+                        );
+                    new_hashes[i_tile] = Display_list::hash_combine( new_hashes[i_tile], hash );
+                } );
+            } );
+
+            Nat n_rasterized = 0;
+            for( Nat i_row = 0; i_row < m_n_tile_rows; ++i_row ) {
+                for( Nat i_col = 0; i_col < m_n_tile_cols; ++i_col ) {
+                    const Nat i_tile = i_row*m_n_tile_cols + i_col;
+                    if( m_tile_is_valid[i_tile] and new_hashes[i_tile] == m_tile_hashes[i_tile] ) {
+                        continue;
+                    }
+                    const RECT r = tile_rect( i_col, i_row );
+                    m_pixels.fill_rect( r, m_background, r );
+                    auto surface = Framebuffer_surface( m_pixels, r );
+                    display_list.replay_to( surface, r );
+                    m_tile_is_valid[i_tile] = true;
+                    ++n_rasterized;
+                }
+            }
+            m_tile_hashes = move( new_hashes );
+            return n_rasterized;
+        }
+    };
+
+    // A retained rendering of a client area. It’s re-rendered only when the size changes or the
+    // content has been invalidated, and is otherwise just copied to satisfy paint requests.
+    //
+    // `Backbuffer` provides `size()`, `resize( size )`, `render( f )`, which clears to the
+    // background and calls `f( surface )`, and `copy_to( target, rect )`.
+    template< class Backbuffer >
+    class Retained_frame_
+    {
+        Backbuffer  m_backbuffer;
+        bool        m_is_current    = false;
+        Nat         m_n_renders     = 0;
+
+    public:
+        template< class... Args >
+        explicit Retained_frame_( Args&&... args ): m_backbuffer( std::forward<Args>( args )... ) {}
+
+        auto n_renders() const -> Nat { return m_n_renders; }
+
+        void invalidate_content() { m_is_current = false; }
+
+        // Renders via `render( surface, size )` if necessary, then copies `update_rect` to `target`.
+        template< class Target, class Render_func >
+        void paint( Target&& target, in_<SIZE> size, in_<RECT> update_rect, Render_func&& render )
+        {
+            const SIZE buffer_size = m_backbuffer.size();
+            if( buffer_size.cx != size.cx or buffer_size.cy != size.cy ) {
+                m_backbuffer.resize( size );
+                m_is_current = false;
+            }
+            if( not m_is_current ) {
+                m_backbuffer.render( [&]( Surface& surface ) { render( surface, size ); } );
+                m_is_current = true;
+                ++m_n_renders;
+            }
+            m_backbuffer.copy_to( target, update_rect );
+        }
+    };
+
+    // A backbuffer for `Retained_frame_` that copies to an `Rgba_framebuffer`.
+    class Framebuffer_backbuffer
+    {
+        Rgba_framebuffer    m_pixels;
+        Rgba                m_background;
+
+    public:
+        explicit Framebuffer_backbuffer( const Rgba background ):
+            m_pixels( SIZE{ 0, 0 }, background ),
+            m_background( background )
+        {}
+
+        auto size() const -> SIZE { return {m_pixels.w(), m_pixels.h()}; }
+        void resize( in_<SIZE> size ) { m_pixels = Rgba_framebuffer( size, m_background ); }
+
+        template< class Func >
+        void render( Func&& f )
+        {
+            m_pixels.fill( m_background );
+            auto surface = Framebuffer_surface( m_pixels );
+            f( surface );
+        }
+
+        void copy_to( Rgba_framebuffer& target, in_<RECT> r ) const { target.copy_rect_from( m_pixels, r ); }
+    };
+
+    // Renders the whole `framebuffer` as tiles in parallel. The result is the same as painting
+    // directly, because each tile only gets the pixels that a direct painting would put there.
+    void rasterize_in_parallel(
+        in_<Display_list>   display_list,
+        Rgba_framebuffer&   framebuffer,
+        const Rgba          background,
+        const Nat           n_threads
+        )
+    {
+        using Part = Display_list::Part;
+        const Nat ts = Tiled_framebuffer::tile_size;
+        const Nat n_tile_cols = (framebuffer.w() + ts - 1)/ts;
+        const Nat n_tile_rows = (framebuffer.h() + ts - 1)/ts;
+
+        // Sort the parts into per tile bins, in drawing order.
+        auto bins = vector<vector<Part>>( size_t( n_tile_cols )*n_tile_rows );
+        display_list.for_each_part( [&]( in_<RECT> bounds, auto, in_<Part> part ) {
+            const RECT area = intersection_of( bounds, framebuffer.bounds() );
+            if( is_empty( area ) ) { return; }
+            for( Nat i_row = area.top/ts; i_row <= (area.bottom - 1)/ts; ++i_row ) {
+                for( Nat i_col = area.left/ts; i_col <= (area.right - 1)/ts; ++i_col ) {
+                    bins[i_row*n_tile_cols + i_col].push_back( part );
+                }
+            }
+        } );
+
+        threading::for_each_index_in_parallel( n_tile_cols*n_tile_rows, n_threads,
+            [&]( const Nat i_tile ) {
+                const Nat x = ts*(i_tile % n_tile_cols);  const Nat y = ts*(i_tile / n_tile_cols);
+                const RECT r = intersection_of( {x, y, x + ts, y + ts}, framebuffer.bounds() );
+                framebuffer.fill_rect( r, background, r );
+                auto surface = Framebuffer_surface( framebuffer, r );
+                for( const Part& part: bins[i_tile] ) { display_list.draw( part, surface ); }
+            } );
+    }
+
+    // Binary PPM, a trivial image format that most image viewers and converters understand.
+    auto save_as_ppm( in_<Rgba_framebuffer> fb, in_<string> file_path )
+        -> bool
+    {
+        auto f = ofstream( file_path, std::ios::binary );
+        f << "P6\n" << fb.w() << ' ' << fb.h() << "\n255\n";
+        for( Nat y = 0; y < fb.h(); ++y ) {
+            for( Nat x = 0; x < fb.w(); ++x ) {
+                const Rgba color = fb.px( x, y );
+                const char rgb[] = { char( color & 0xFF ), char( (color >> 8) & 0xFF ), char( (color >> 16) & 0xFF ) };
+                f.write( rgb, 3 );
+            }
+        }
+        return not f.fail();
+    }
+}  // graphics
+
+namespace files {
+    using   cppm::in_;
+
+    namespace fs = std::filesystem;     // <filesystem>
+    using   std::string;                // <string>
+
+    using   std::size_t;                // <cstddef>
+
+    // A path in the system’s directory for temporary files, or just `name` if there is none. As
+    // a `fs::path`, which in Windows is UTF-16 and so also handles non-ASCII user names.
+    auto temp_file_path( in_<string> name )
+        -> fs::path
+    {
+        std::error_code error;
+        const fs::path directory = fs::temp_directory_path( error );
+        return (error? fs::path( name ) : directory/name);
+    }
+
+    // A read-only memory mapping of a whole file. Pages are read from the file when they’re first
+    // touched, and can be evicted again, so the file can be larger than the RAM.
+    class Read_only_mapping
+    {
+        const void*     m_p_bytes   = nullptr;
+        size_t          m_size      = 0;
+    #ifdef _WIN32
+        HANDLE          m_file      = INVALID_HANDLE_VALUE;
+        HANDLE          m_mapping   = nullptr;
+    #endif
+
+    public:
+        Read_only_mapping( in_<Read_only_mapping> ) = delete;
+        auto operator=( in_<Read_only_mapping> ) -> Read_only_mapping& = delete;
+
+        explicit Read_only_mapping( in_<fs::path> file_path )
+        {
+        #ifdef _WIN32
+            m_file = CreateFileW(
+                file_path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, HANDLE()
+                );
+            LARGE_INTEGER size;
+            if( m_file == INVALID_HANDLE_VALUE or not GetFileSizeEx( m_file, &size ) or size.QuadPart == 0 ) {
+                return;
+            }
+            m_mapping = CreateFileMapping( m_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            if( not m_mapping ) { return; }
+            m_p_bytes = MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+            if( m_p_bytes ) { m_size = size_t( size.QuadPart ); }
+        #else
+            const int fd = open( file_path.c_str(), O_RDONLY );
+            if( fd < 0 ) { return; }
+            struct stat info;
+            if( fstat( fd, &info ) == 0 and info.st_size > 0 ) {
+                void* const p = mmap( nullptr, size_t( info.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+                if( p != MAP_FAILED ) { m_p_bytes = p;  m_size = size_t( info.st_size ); }
+            }
+            close( fd );        // The mapping keeps the file open.
+        #endif
+        }
+
+        ~Read_only_mapping()
+        {
+        #ifdef _WIN32
+            if( m_p_bytes ) { UnmapViewOfFile( m_p_bytes ); }
+            if( m_mapping ) { CloseHandle( m_mapping ); }
+            if( m_file != INVALID_HANDLE_VALUE ) { CloseHandle( m_file ); }
+        #else
+            if( m_p_bytes ) { munmap( const_cast<void*>( m_p_bytes ), m_size ); }
+        #endif
+        }
+
+        auto is_valid() const -> bool { return m_p_bytes != nullptr; }
+        auto data() const -> const void* { return m_p_bytes; }
+        auto size() const -> size_t { return m_size; }
+    };
+}  // files
+
+namespace events {
+    struct Event
+    {
+        struct Kind{ enum Enum: int { size, paint, destroy }; };
+
+        Kind::Enum  kind;
+        SIZE        size;               // For `size`: the new client area size.
+        RECT        update_rect;        // For `paint`: the area to update.
+    };
+
+    // A source of the events for a window. In Windows the system’s message queue is the source,
+    // and the window procedure translates messages to events.
+    class Event_source
+    {
+    public:
+        virtual ~Event_source() {}
+
+        virtual auto next( Event& e ) -> bool = 0;      // `false` ⇨ quit.
+    };
+
+    // Dispatches the events from `source` to `window.handle` until the source says quit.
+    template< class Window >
+    void run_event_loop( Event_source& source, Window& window )
+    {
+        Event e;
+        while( source.next( e ) ) { window.handle( e ); }
+    }
+}  // events
+
+#ifdef _WIN32
+namespace winapi {
+    using   cppm::Nat, cppm::in_;
+
+    using   std::vector;                // <vector>
+
+    auto client_rect_of( const HWND window )
+        -> RECT
+    {
+        RECT r;
+        GetClientRect( window, &r );
+        return r;
+    }
+
+    auto extent_of( in_<RECT> r ) -> SIZE { return {r.right - r.left, r.bottom - r.top}; }
+
+    // Draws on a DC in black. Each GDI call has a cost of its own, so a frame is drawn via the
+    // batch. Reuse an instance to reuse the batch and the buffer for the `PolyPolyline` counts.
+    class Dc_surface: public graphics::Surface
+    {
+        HDC                         m_dc;
+        graphics::Primitive_batch   m_batch;
+        vector<DWORD>               m_dword_counts;
+
+        static auto black_brush() -> HBRUSH { return static_cast<HBRUSH>( GetStockObject( BLACK_BRUSH ) ); }
+
+    public:
+        Dc_surface( const HDC dc ): m_dc( dc ) {}
+
+        void polyline( const POINT* points, const Nat n ) override { Polyline( m_dc, points, n ); }
+
+        void fill_rect( in_<RECT> r ) override { FillRect( m_dc, &r, black_brush() ); }
+
+        void poly_polyline( const POINT* points, const Nat* const counts, const Nat n_polylines ) override
+        {
+            m_dword_counts.assign( counts, counts + n_polylines );
+            PolyPolyline( m_dc, points, m_dword_counts.data(), n_polylines );
+        }
+
+        // GDI has no call to fill a list of rectangles. `FillRect` selects its brush into the DC
+        // for each call, so here the brush is selected once and each rectangle is a `PatBlt`.
+        void fill_rects( const RECT* const rects, const Nat n ) override
+        {
+            if( n == 0 ) { return; }
+            const HGDIOBJ original_brush = SelectObject( m_dc, black_brush() );
+            for( Nat i = 0; i < n; ++i ) {
+                const RECT& r = rects[i];
+                PatBlt( m_dc, r.left, r.top, r.right - r.left, r.bottom - r.top, PATCOPY );
+            }
+            SelectObject( m_dc, original_brush );
+        }
+
+        auto batch() -> graphics::Primitive_batch* override { return &m_batch; }
+    };
+
+    // A backbuffer for `graphics::Retained_frame_`: a bitmap selected in a memory DC, that copies
+    // to a window’s DC.
+    class Bitmap_backbuffer
+    {
+        HBRUSH      m_background;
+        HDC         m_dc                = CreateCompatibleDC( nullptr );    // Like the screen.
+        Dc_surface  m_surface           = Dc_surface( m_dc );
+        HBITMAP     m_bitmap            = nullptr;
+        HGDIOBJ     m_original_bitmap   = nullptr;
+        SIZE        m_size              = {0, 0};
+
+    public:
+        Bitmap_backbuffer( in_<Bitmap_backbuffer> ) = delete;
+        auto operator=( in_<Bitmap_backbuffer> ) -> Bitmap_backbuffer& = delete;
+
+        explicit Bitmap_backbuffer( const HBRUSH background ): m_background( background ) {}
+
+        ~Bitmap_backbuffer()
+        {
+            if( m_bitmap ) { SelectObject( m_dc, m_original_bitmap );  DeleteObject( m_bitmap ); }
+            DeleteDC( m_dc );
+        }
+
+        auto size() const -> SIZE { return m_size; }
+
+        void resize( in_<SIZE> size )
+        {
+            if( m_bitmap ) { SelectObject( m_dc, m_original_bitmap );  DeleteObject( m_bitmap ); }
+            const HDC screen_dc = GetDC( HWND() );      // A memory DC’s own bitmap is monochrome.
+            m_bitmap = CreateCompatibleBitmap( screen_dc, size.cx, size.cy );
+            ReleaseDC( HWND(), screen_dc );
+            m_original_bitmap = SelectObject( m_dc, m_bitmap );
+            m_size = size;
+        }
+
+        template< class Func >
+        void render( Func&& f )
+        {
+            const RECT all = {0, 0, m_size.cx, m_size.cy};
+            FillRect( m_dc, &all, m_background );
+            f( m_surface );
+        }
+
+        void copy_to( const HDC target, in_<RECT> r ) const
+        {
+            BitBlt( target, r.left, r.top, r.right - r.left, r.bottom - r.top, m_dc, r.left, r.top, SRCCOPY );
+        }
+    };
+}  // winapi
+#endif
+
+namespace app {
+    using   cppm::Nat, cppm::C_str, cppm::in_, cppm::Process_exit_code, cppm::sign_of;
+
+    using   std::max, std::min,     // <algorithm>
+            std::function,          // <functional>
+            std::cout,              // <iostream>
+            std::string,            // <string>
+            std::move,              // <utility>
+            std::vector;            // <vector>
+
+    using   std::trunc;             // <cmath>
+    using   std::size_t;            // <cstddef>
+
+    const auto& window_class_name   = L"Main window";
+    const auto& window_title        = L"Parabola (x²/4) — graph by 日本国 кошка, v6";
+
+    namespace coordinate {
+        using   geometry::Handedness, geometry::Point_vector_;
+
+        using   std::max, std::min;         // <algorithm>
+        using   std::int64_t;               // <cstdint>
+
+        struct Math_point{ double x; double y; };
+        using Px_point          = POINT;                    // Pixel location.
+        static_assert( sizeof( Px_point::x ) == sizeof( int ) );    // Holds in Windows.
+        using Px_point_vector   = Point_vector_<Px_point, Handedness::opposite_math>;
+
+        enum class Px_index: int {};    // Pixel indexing for a math axis.
+        void operator++( Px_index& v )                          { v = Px_index( int( v ) + 1 ); }
+        auto value_before( Px_index v )             -> Px_index { return Px_index( int( v ) - 1 ); }
+        auto operator<=( Px_index a, Px_index b )   -> bool     { return int( a ) <= int( b ); }
+
+        // A math value in fixed point, see `Indices_transform::fixed_units_per_math`.
+        enum class Fixed_math_value: int64_t {};
+
+        // Math ↔ pixel indices.
+        // Holds all knowledge of the graph orientation.
+        class Indices_transform
+        {
+            // Scaling so that e.g. math x = -15 maps to px row -150.
+            static constexpr double     scaling         = 10;
+            static constexpr double     minimum_y       = -2.0; // In display’s left edge.
+            static constexpr Nat        i_px_col_y_zero = int( scaling*( 0.0 - minimum_y ) );
+
+            // Pixel indices from math values saturate at ±`px_index_limit`, so that a huge value or
+            // a NaN doesn’t overflow `int`, and differences of indices fit in an `int`.
+            static constexpr Nat        px_index_limit  = 1 << 29;
+
+            static auto saturated( const double v )
+                -> double
+            { return max<double>( -px_index_limit, min<double>( px_index_limit, v ) ); }    // NaN ⇨ limit.
+
+            static auto saturated( const int64_t v )
+                -> int64_t
+            { return max<int64_t>( -px_index_limit, min<int64_t>( px_index_limit, v ) ); }
+
+            const Nat   m_w;
+            const Nat   m_h;
+            const Nat   m_i_px_row_middle;
+
+        public:
+            Indices_transform( const Nat w, const Nat h ):
+                m_w( w ),
+                m_h( h ),
+                m_i_px_row_middle( h/2 )
+            {
+                assert( m_w >= 0 );
+                assert( m_h >= 0 );
+            }
+
+            explicit Indices_transform( in_<SIZE> size ): Indices_transform( size.cx, size.cy ) {}
+
+
+            //------------------------------- Axis 1 pixel length vectors:
+
+            auto px_unit_for_math_x() const -> Px_point_vector { return {0, 1}; }         // ↓
+            auto px_unit_for_math_y() const -> Px_point_vector { return {1, 0}; }         // →
+
+
+            //------------------------------- Indices:
+
+            auto px_index_from_math_x( const double x ) const
+                -> Px_index
+            { return Px_index( m_i_px_row_middle + int( saturated( scaling*x ) ) ); }
+
+            auto px_index_from_math_y( const double y ) const
+                -> Px_index
+            { return Px_index( i_px_col_y_zero + int( saturated( scaling*y ) ) ); }
+
+            auto px_index_beyond_x_axis() const -> Px_index { return Px_index( m_h ); }
+            auto px_index_beyond_y_axis() const -> Px_index { return Px_index( m_w ); }
+
+            auto px_size() const -> SIZE { return {m_w, m_h}; }
+
+            auto math_x_from( const Px_index i_px ) const
+                -> double
+            {
+                const int i = int( i_px );
+                return 1.0*(i - m_i_px_row_middle)/scaling;
+            }
+
+            auto math_y_from( const Px_index i_px ) const
+                -> double
+            {
+                const int i = int( i_px );
+                return 1.0*(i - i_px_col_y_zero)/scaling;
+            }
+
+            // The difference in math x between consecutive pixel indices.
+            auto math_x_step() const -> double { return 1/scaling; }
+
+
+            //------------------------------- Batch versions, two values at a time with SSE2:
+
+        #ifdef HAS_SSE2
+            // As the scalar `saturated`, also for NaN.
+            static auto saturated( const __m128d v )
+                -> __m128d
+            { return _mm_max_pd( _mm_min_pd( v, _mm_set1_pd( px_index_limit ) ), _mm_set1_pd( -px_index_limit ) ); }
+        #endif
+
+            // `xs[k]` = `math_x_from( i_px_first + k )` for k in [0, n).
+            void math_xs_from( const Px_index i_px_first, const Nat n, double* const xs ) const
+            {
+                const int i_first = int( i_px_first ) - m_i_px_row_middle;
+                Nat k = 0;
+            #ifdef HAS_SSE2
+                __m128i i_pair = _mm_setr_epi32( i_first, i_first + 1, 0, 0 );
+                for( ; k + 2 <= n; k += 2 ) {
+                    _mm_storeu_pd( xs + k, _mm_div_pd( _mm_cvtepi32_pd( i_pair ), _mm_set1_pd( scaling ) ) );
+                    i_pair = _mm_add_epi32( i_pair, _mm_set1_epi32( 2 ) );
+                }
+            #endif
+                for( ; k < n; ++k ) { xs[k] = 1.0*(i_first + k)/scaling; }
+            }
+
+            // `indices[k]` = `int( px_index_from_math_x( xs[k] ) )` for k in [0, n).
+            void px_indices_from_math_xs( const double* const xs, const Nat n, int* const indices ) const
+            {
+                Nat k = 0;
+            #ifdef HAS_SSE2
+                for( ; k + 2 <= n; k += 2 ) {
+                    const __m128d   scaled  = _mm_mul_pd( _mm_set1_pd( scaling ), _mm_loadu_pd( xs + k ) );
+                    const __m128i   pair    = _mm_add_epi32(
+                        _mm_cvttpd_epi32( saturated( scaled ) ), _mm_set1_epi32( m_i_px_row_middle )
+                        );
+                    _mm_storel_epi64( reinterpret_cast<__m128i*>( indices + k ), pair );
+                }
+            #endif
+                for( ; k < n; ++k ) { indices[k] = m_i_px_row_middle + int( saturated( scaling*xs[k] ) ); }
+            }
+
+            // `indices[k]` = `int( px_index_from_math_y( ys[k] ) )` for k in [0, n).
+            void px_indices_from_math_ys( const double* const ys, const Nat n, int* const indices ) const
+            {
+                Nat k = 0;
+            #ifdef HAS_SSE2
+                for( ; k + 2 <= n; k += 2 ) {
+                    const __m128d   scaled  = _mm_mul_pd( _mm_set1_pd( scaling ), _mm_loadu_pd( ys + k ) );
+                    const __m128i   pair    = _mm_add_epi32(
+                        _mm_cvttpd_epi32( saturated( scaled ) ), _mm_set1_epi32( i_px_col_y_zero )
+                        );
+                    _mm_storel_epi64( reinterpret_cast<__m128i*>( indices + k ), pair );
+                }
+            #endif
+                for( ; k < n; ++k ) { indices[k] = i_px_col_y_zero + int( saturated( scaling*ys[k] ) ); }
+            }
+
+            // This is an optimization in the sense that it could be expressed in terms of the unit
+            // vectors, without knowledge of the graph orientation, at the cost of some operations.
+            // But mostly it’s here because a gut feeling that it should be expressed with scalars.
+            auto px_pt_from_indices( const Px_index i_px_for_x, const Px_index i_px_for_y ) const
+                -> Px_point
+            { return {int( i_px_for_y ), int( i_px_for_x )}; }
+
+            // The pixel coordinate arrays for respectively math x and math y indices, as
+            // `px_pt_from_indices` but for structure of arrays batches.
+            auto px_arrays_for_indices( int* const px_xs, int* const px_ys ) const
+                -> std::pair<int*, int*>
+            { return {px_ys, px_xs}; }
+
+
+            //------------------------------- Fixed point versions, integer only:
+            //
+            // A pixel index step is exactly `fixed_units_per_px` units, so math values for
+            // consecutive pixel indices are produced by adding that, DDA style. Pixel indices are
+            // truncated toward zero like `int()` does. For pixel indices in [-2¹⁵, 2¹⁵), and fixed
+            // math values in the corresponding range, the results are identical to those of the
+            // `double` functions, which `report_on_fixed_point_transform` checks for every value.
+
+            static constexpr Nat    fixed_units_per_px      = 256;
+            static constexpr Nat    fixed_units_per_math    = int( scaling )*fixed_units_per_px;
+
+            // Exact, as `double` when the value is less than 2⁵³ units.
+            static auto math_value_from( const Fixed_math_value v )
+                -> double
+            { return 1.0*int64_t( v )/fixed_units_per_math; }
+
+            auto px_index_from_fixed_math_x( const Fixed_math_value x ) const
+                -> Px_index
+            { return Px_index( m_i_px_row_middle + int( saturated( int64_t( x )/fixed_units_per_px ) ) ); }
+
+            auto px_index_from_fixed_math_y( const Fixed_math_value y ) const
+                -> Px_index
+            { return Px_index( i_px_col_y_zero + int( saturated( int64_t( y )/fixed_units_per_px ) ) ); }
+
+            auto fixed_math_x_from( const Px_index i_px ) const
+                -> Fixed_math_value
+            { return Fixed_math_value( int64_t( int( i_px ) - m_i_px_row_middle )*fixed_units_per_px ); }
+
+            auto fixed_math_y_from( const Px_index i_px ) const
+                -> Fixed_math_value
+            { return Fixed_math_value( int64_t( int( i_px ) - i_px_col_y_zero )*fixed_units_per_px ); }
+
+            // The difference in fixed point math x between consecutive pixel indices.
+            auto fixed_math_x_step() const -> Fixed_math_value { return Fixed_math_value( fixed_units_per_px ); }
+        };
+
+        // Math coordinate ↔ pixel coordinate:
+        class Coordinates_transform: public Indices_transform
+        {
+            using Base = Indices_transform;
+
+            const Math_point    m_math_start  =     // The math point for pixel (0, 0).
+            {
+                math_x_from( Px_index( 0 ) ), math_y_from( Px_index( 0 ) )
+            };
+            const Math_point    m_math_beyond =     // The math point for pixel (beyond, beyond).
+            {
+                math_x_from( px_index_beyond_x_axis() ), math_y_from( px_index_beyond_y_axis() )
+            };
+
+        public:
+            using Base::Base;       // Constructors.
+
+            using Base::px_pt_from_indices;
+
+            auto px_pt_from( in_<Math_point> math ) const
+                -> Px_point
+            {
+                const auto  i_px_x  = px_index_from_math_x( math.x );
+                const auto  i_px_y  = px_index_from_math_y( math.y );
+                return px_pt_from_indices( i_px_x, i_px_y );
+            }
+
+            // Structure of arrays batch version of `px_pt_from`, for the math points (xs[k], ys[k])
+            // with k in [0, n). The default pixel handedness is that of a window, with y down; with
+            // `Handedness::like_math` pixel y is up, i.e. rows are counted from the bottom as in
+            // e.g. OpenGL. The handedness is a compile time choice so the loops are branch free.
+            template< Handedness::Enum px_handedness = Handedness::opposite_math >
+            void px_pts_from(
+                const double* const     xs,
+                const double* const     ys,
+                const Nat               n,
+                int* const              px_xs,
+                int* const              px_ys
+                ) const
+            {
+                const auto [indices_for_x, indices_for_y] = px_arrays_for_indices( px_xs, px_ys );
+                px_indices_from_math_xs( xs, n, indices_for_x );
+                px_indices_from_math_ys( ys, n, indices_for_y );
+                if constexpr( px_handedness == Handedness::like_math ) {
+                    const int i_px_y_last = px_size().cy - 1;
+                    for( Nat k = 0; k < n; ++k ) { px_ys[k] = i_px_y_last - px_ys[k]; }
+                }
+            }
+
+            auto math_minimum_x() const -> double { return min( m_math_start.x, m_math_beyond.x ); }
+            auto math_maximum_x() const -> double { return max( m_math_start.x, m_math_beyond.x ); }
+
+            auto math_minimum_y() const -> double { return min( m_math_start.y, m_math_beyond.y ); }
+            auto math_maximum_y() const -> double { return max( m_math_start.y, m_math_beyond.y ); }
+        };
+
+        class Axis_relative_transform: public Coordinates_transform
+        {
+            using Base = Coordinates_transform;
+
+        public:
+            using Base::Base;       // Constructors.
+
+            struct Math_axis{ enum Enum: int { x, y }; };
+            static constexpr Math_axis::Enum math_axes[] = { Math_axis::x, Math_axis::y };
+
+            template< Math_axis::Enum axis >
+            using Math_axis_constant_ = std::integral_constant<Math_axis::Enum, axis>;
+
+            // Calls `f( Math_axis_constant_<axis>() )` for each axis, unrolled at compile time.
+            template< class Func >
+            static void for_each_math_axis( Func&& f )
+            {
+                f( Math_axis_constant_<Math_axis::x>() );
+                f( Math_axis_constant_<Math_axis::y>() );
+            }
+
+            //------------------------------- With the axis as a compile time constant:
+
+            template< Math_axis::Enum axis >
+            auto px_unit_vector_for() const
+                -> Px_point_vector
+            {
+                if constexpr( axis == Math_axis::x ) { return px_unit_for_math_x(); }
+                else { return px_unit_for_math_y(); }
+            }
+
+            using Base::px_pt_from;     // Unshadowing.
+
+            template< Math_axis::Enum axis >
+            auto px_pt_from( const double v ) const
+                -> Px_point
+            {
+                if constexpr( axis == Math_axis::x ) { return px_pt_from( {v, 0} ); }
+                else { return px_pt_from( {0, v} ); }
+            }
+
+            template< Math_axis::Enum axis >
+            auto math_minimum() const
+                -> double
+            {
+                if constexpr( axis == Math_axis::x ) { return math_minimum_x(); }
+                else { return math_minimum_y(); }
+            }
+
+            template< Math_axis::Enum axis >
+            auto math_maximum() const
+                -> double
+            {
+                if constexpr( axis == Math_axis::x ) { return math_maximum_x(); }
+                else { return math_maximum_y(); }
+            }
+
+            template< Math_axis::Enum >
+            auto px_i_first() const
+                -> Px_index
+            { return Px_index( 0 ); }
+
+            template< Math_axis::Enum axis >
+            auto px_i_beyond() const
+                -> Px_index
+            {
+                if constexpr( axis == Math_axis::x ) { return px_index_beyond_x_axis(); }
+                else { return px_index_beyond_y_axis(); }
+            }
+
+            //------------------------------- With the axis chosen at run time:
+
+            auto px_unit_vector_for( const Math_axis::Enum axis ) const
+                -> Px_point_vector
+            { return (axis == Math_axis::x? px_unit_vector_for<Math_axis::x>() : px_unit_vector_for<Math_axis::y>()); }
+
+            auto px_pt_from( const Math_axis::Enum axis, const double v ) const
+                -> Px_point
+            { return (axis == Math_axis::x? px_pt_from<Math_axis::x>( v ) : px_pt_from<Math_axis::y>( v )); }
+
+            auto math_minimum( const Math_axis::Enum axis ) const
+                -> double
+            { return (axis == Math_axis::x? math_minimum<Math_axis::x>() : math_minimum<Math_axis::y>()); }
+
+            auto math_maximum( const Math_axis::Enum axis ) const
+                -> double
+            { return (axis == Math_axis::x? math_maximum<Math_axis::x>() : math_maximum<Math_axis::y>()); }
+
+            auto px_i_first( const Math_axis::Enum axis ) const
+                -> Px_index
+            { return (axis == Math_axis::x? px_i_first<Math_axis::x>() : px_i_first<Math_axis::y>()); }
+
+            auto px_i_beyond( const Math_axis::Enum axis ) const
+                -> Px_index
+            { return (axis == Math_axis::x? px_i_beyond<Math_axis::x>() : px_i_beyond<Math_axis::y>()); }
+        };
+    }  // coordinate
+
+    // The plotted function of the GUI program, as a type so that calls can be inlined.
+    struct Parabola
+    {
+        auto operator()( const double x ) const -> double { return x*x/4; }
+
+        // x²/4 rounded down to a whole unit, which with |x| < 2³¹ units doesn’t overflow.
+        auto operator()( const coordinate::Fixed_math_value x ) const
+            -> coordinate::Fixed_math_value
+        {
+            using Ct = coordinate::Indices_transform;
+            const auto units = std::int64_t( x );
+            return coordinate::Fixed_math_value( units*units/(4*Ct::fixed_units_per_math) );
+        }
+    };
+
+    // For a function chosen at run time, e.g. supplied by the user.
+    using Runtime_function = function<auto( const double ) -> double>;
+
+    // Evaluates a function over a span of x values. This general version calls the function for
+    // each value, directly.
+    template< class Func >
+    class Span_evaluator_
+    {
+        const Func&     m_f;
+
+    public:
+        Span_evaluator_( in_<Func> f, double /* x_step */ ): m_f( f ) {}
+
+        void operator()( const double* const xs, const Nat n, double* const ys )
+        {
+            for( Nat k = 0; k < n; ++k ) { ys[k] = m_f( xs[k] ); }
+        }
+    };
+
+    // For a polynomial the x values must be `x_step` apart. Each value costs d additions, via
+    // forward differences. These are anchored at the first value and carried on across spans
+    // that continue where the previous one ended, so the O(d²) anchoring is amortized over a
+    // whole period, by default the whole plot. When the drift at the end of a span exceeds the
+    // error bound of a direct evaluation, the span is redone from a new anchor with the period
+    // halved, which it then stays at, or with direct evaluation when the halved period would be
+    // too short to pay for the anchoring. A period of 0 means direct evaluation, which is also
+    // used for values that don’t fill a group of lanes.
+    template<>
+    class Span_evaluator_<numerics::Polynomial>
+    {
+        static constexpr Nat n_lanes    = numerics::Forward_differences::n_lanes;
+        static constexpr Nat min_period = 256;      // Shorter doesn’t pay for the anchoring.
+
+        const numerics::Polynomial&     m_p;
+        numerics::Forward_differences   m_differences;
+        double                          m_x_step;
+        Nat                             m_period    = std::numeric_limits<Nat>::max()/2;
+        double                          m_x_anchor  = 0;
+        Nat                             m_n_stepped = 0;    // Values since the anchor; 0 = none.
+
+    public:
+        Span_evaluator_( in_<numerics::Polynomial> p, const double x_step ):
+            m_p( p ),
+            m_differences( p, x_step ),
+            m_x_step( x_step )
+        {}
+
+        auto period() const -> Nat { return m_period; }
+
+        void operator()( const double* const xs, const Nat n, double* const ys )
+        {
+            Nat k = 0;
+            while( m_period > 0 and n - k >= n_lanes ) {
+                const double x_next = m_x_anchor + m_n_stepped*m_x_step;
+                const bool continues = (
+                    m_n_stepped > 0 and m_n_stepped < m_period and std::abs( xs[k] - x_next ) < m_x_step/2
+                    );
+                if( not continues ) {
+                    m_differences.anchor_at( xs[k] );
+                    m_x_anchor = xs[k];
+                    m_n_stepped = 0;
+                }
+
+                const Nat n_values = min( m_period - m_n_stepped, (n - k)/n_lanes*n_lanes );
+                m_differences.produce( ys + k, n_values/n_lanes );
+                m_n_stepped += n_values;
+
+                // The lanes drift differently, so each is checked at the end of the span, against
+                // the smallest error bound in the span, at the x nearest 0 since it grows with |x|.
+                const double x_end = m_x_anchor + (m_n_stepped + n_lanes - 1)*m_x_step;
+                const double x_nearest_0 = std::clamp( 0.0, min( xs[k], x_end ), std::max( xs[k], x_end ) );
+                double drift = 0;
+                for( Nat i = 0; i < n_lanes; ++i ) {
+                    const double x = m_x_anchor + (m_n_stepped + i)*m_x_step;
+                    drift = std::max( drift, std::abs( m_differences.lane_value( i ) - m_p( x ) ) );
+                }
+                if( drift > m_p.error_bound_at( x_nearest_0 ) ) {
+                    const Nat halved = m_n_stepped/2/n_lanes*n_lanes;
+                    m_period = (halved >= min_period? halved : 0);
+                    m_n_stepped = 0;
+                    continue;
+                }
+                k += n_values;
+            }
+            if( k < n ) { m_n_stepped = 0; }
+            for( ; k < n; ++k ) { ys[k] = m_p( xs[k] ); }
+        }
+    };
+
+    // Plots the graph of a function, with markers. This interface lets the function be chosen at
+    // run time at the cost of one virtual call per plot, instead of one per sample.
+    class Function_plotter
+    {
+    protected:
+        using Ct                = coordinate::Axis_relative_transform;      // Coordinate Transform
+        using Px_point          = coordinate::Px_point;
+        using Px_index          = coordinate::Px_index;
+
+    public:
+        virtual ~Function_plotter() {}
+
+        virtual void plot( graphics::Surface& surface, in_<Ct> transform ) const = 0;
+
+        virtual void add_markers( graphics::Surface& surface, in_<Ct> transform ) const = 0;
+    };
+
+    // With a function object type such as `Parabola` the function calls are inlined in the
+    // sampling loop, and when the function object also takes a fixed point math value, as
+    // `Parabola` does, the loop is integer only. With `Runtime_function` each sample costs an
+    // indirect call. With `numerics::Polynomial` the samples are computed with forward differences.
+    template< class Func >
+    class Function_plotter_: public Function_plotter
+    {
+        using Fixed_math_value = coordinate::Fixed_math_value;
+
+        static constexpr bool has_fixed_point = std::is_invocable_r_v<Fixed_math_value, const Func&, Fixed_math_value>;
+
+        Func    m_f;
+
+    public:
+        Function_plotter_( Func f ): m_f( move( f ) ) {}
+
+        auto f( const double x ) const -> double { return m_f( x ); }
+
+        // The graph’s points, from just outside the client area at one end to just outside at the
+        // other, before clipping.
+        auto sampled_points( in_<Ct> transform ) const
+            -> vector<POINT>
+        {
+            const auto& _ = transform;
+            constexpr auto x_axis = Ct::Math_axis::x;
+
+            const Px_index      i_px_first      = _.px_i_first<x_axis>();
+            const Px_index      i_px_beyond     = _.px_i_beyond<x_axis>();
+            const auto          n_px_indices    = int( i_px_beyond );
+
+            const Px_index      i_px_start      = value_before( i_px_first );
+            const Nat           n_px_steps      = n_px_indices + 1;     // To 1 outside at each end.
+            const Nat           n_points        = n_px_steps + 1;
+
+            auto points = vector<POINT>( n_points );
+            if constexpr( has_fixed_point ) {
+                // Integer only, with math x stepped in fixed point.
+                const auto x_step = std::int64_t( _.fixed_math_x_step() );
+                auto x = _.fixed_math_x_from( i_px_start );
+                for( Nat k = 0; k < n_points; ++k ) {
+                    const auto i_px_for_x = Px_index( int( i_px_start ) + k );
+                    points[k] = _.px_pt_from_indices( i_px_for_x, _.px_index_from_fixed_math_y( m_f( x ) ) );
+                    x = Fixed_math_value( std::int64_t( x ) + x_step );
+                }
+            } else {
+                // Sampling in batch stages over spans that fit in the L1 cache, with separate value arrays.
+                constexpr Nat span_size = 256;
+                double  xs[span_size];
+                double  ys[span_size];
+                int     i_pxs_for_y[span_size];
+
+                auto evaluate = Span_evaluator_<Func>( m_f, _.math_x_step() );
+                for( Nat i_span_start = 0; i_span_start < n_points; i_span_start += span_size ) {
+                    const Nat n = min( span_size, n_points - i_span_start );
+                    const auto i_px_span_start = Px_index( int( i_px_start ) + i_span_start );
+
+                    _.math_xs_from( i_px_span_start, n, xs );
+                    evaluate( xs, n, ys );
+                    _.px_indices_from_math_ys( ys, n, i_pxs_for_y );
+
+                    for( Nat k = 0; k < n; ++k ) {
+                        const auto i_px_for_x = Px_index( int( i_px_span_start ) + k );
+                        points[i_span_start + k] = _.px_pt_from_indices( i_px_for_x, Px_index( i_pxs_for_y[k] ) );
+                    }
+                }
+            }
+
+            return points;
+        }
+
+        void plot( graphics::Surface& surface, in_<Ct> transform ) const override
+        {
+            const vector<POINT> points = sampled_points( transform );
+
+            // Only the visible parts go to the surface, since steep functions go far outside.
+            const SIZE size = transform.px_size();
+            graphics::draw_clipped_polyline( surface, points.data(), Nat( points.size() ), RECT{ 0, 0, size.cx, size.cy } );
+        }
+
+        void add_markers( graphics::Surface& surface, in_<Ct> transform ) const override
+        {
+            // Add markers on the graph for every 5 math units of math x axis.
+            const auto& _ = transform;
+            const Nat td = 5;
+
+            const double    min_marker_x    = td*trunc( _.math_minimum_x()/td );
+            const double    max_marker_x    = td*trunc( _.math_maximum_x()/td );
+
+            // Note: looping over integer values.
+            vector<double> xs;
+            vector<double> ys;
+            for( double x = min_marker_x; x <= max_marker_x; x += td ) {
+                xs.push_back( x );  ys.push_back( f( x ) );
+            }
+
+            const auto n = Nat( xs.size() );
+            auto px_xs = vector<int>( n );
+            auto px_ys = vector<int>( n );
+            _.px_pts_from( xs.data(), ys.data(), n, px_xs.data(), px_ys.data() );
+            for( Nat k = 0; k < n; ++k ) {
+                const auto square_marker_rect = RECT{ px_xs[k] - 2, px_ys[k] - 2, px_xs[k] + 3, px_ys[k] + 3 };
+                surface.fill_rect( square_marker_rect );
+            }
+        }
+    };
+
+    const auto the_parabola_plotter = Function_plotter_<Parabola>( Parabola() );
+
+    // A recorded series of samples with non-decreasing x, in two arrays.
+    struct Series_arrays
+    {
+        const double*   xs;
+        const double*   ys;
+        size_t          n;
+
+        auto size() const -> size_t { return n; }
+        auto x( const size_t i ) const -> double { return xs[i]; }
+        auto y( const size_t i ) const -> double { return ys[i]; }
+    };
+
+    // M4 decimation of a series: for the samples with the same pixel index for x, only the first,
+    // minimum, maximum and last pixel index for y are needed to draw the same pixels. A polyline
+    // through those four stays within the same pixel row or column, covering the same range.
+    struct M4_bucket{ int i_px_for_x; int first; int min; int max; int last; };
+
+    void add_to( vector<M4_bucket>& buckets, in_<M4_bucket> bucket )
+    {
+        if( buckets.empty() or buckets.back().i_px_for_x != bucket.i_px_for_x ) {
+            buckets.push_back( bucket );
+            return;
+        }
+        M4_bucket& b = buckets.back();
+        b.min = min( b.min, bucket.min );
+        b.max = max( b.max, bucket.max );
+        b.last = bucket.last;
+    }
+
+    // Buckets of samples [i_first, i_beyond) of the `series`.
+    template< class Series >
+    auto m4_buckets_of(
+        in_<Series>                             series,
+        const size_t                            i_first,
+        const size_t                            i_beyond,
+        in_<coordinate::Indices_transform>      transform
+        ) -> vector<M4_bucket>
+    {
+        vector<M4_bucket> buckets;
+        for( size_t i = i_first; i < i_beyond; ++i ) {
+            const auto i_px_for_x = int( transform.px_index_from_math_x( series.x( i ) ) );
+            const auto i_px_for_y = int( transform.px_index_from_math_y( series.y( i ) ) );
+            add_to( buckets, {i_px_for_x, i_px_for_y, i_px_for_y, i_px_for_y, i_px_for_y} );
+        }
+        return buckets;
+    }
+
+    // The range is decimated in chunks on `n_threads` threads, then the chunks’ buckets are merged.
+    template< class Series >
+    auto m4_buckets_of(
+        in_<Series>                             series,
+        const size_t                            i_first,
+        const size_t                            i_beyond,
+        in_<coordinate::Indices_transform>      transform,
+        const Nat                               n_threads
+        ) -> vector<M4_bucket>
+    {
+        const size_t    n           = i_beyond - i_first;
+        const Nat       n_chunks    = (n_threads == 1? 1 : 4*n_threads);
+        auto chunk_buckets = vector<vector<M4_bucket>>( n_chunks );
+        threading::for_each_index_in_parallel( n_chunks, n_threads, [&]( const Nat i ) {
+            chunk_buckets[i] = m4_buckets_of(
+                series, i_first + n*i/n_chunks, i_first + n*(i + 1)/n_chunks, transform
+                );
+        } );
+
+        vector<M4_bucket> result = move( chunk_buckets[0] );
+        for( Nat i = 1; i < n_chunks; ++i ) {
+            for( const M4_bucket& bucket: chunk_buckets[i] ) { add_to( result, bucket ); }
+        }
+        return result;
+    }
+
+    // The points of a polyline through the buckets, that draws the same pixels as a polyline
+    // through all the samples. Rows of buckets before pixel index 0 for x or from `i_px_beyond`
+    // on are reduced to the one sample next to the visible rows, so there are at most about 4
+    // points per visible pixel index.
+    auto m4_polyline_points(
+        in_<vector<M4_bucket>>                  buckets,
+        in_<coordinate::Indices_transform>      transform,
+        const Nat                               i_px_beyond
+        ) -> vector<POINT>
+    {
+        using coordinate::Px_index;
+        vector<POINT> points;
+        const auto add = [&]( const int i_px_for_x, const int i_px_for_y ) {
+            const POINT pt = transform.px_pt_from_indices( Px_index( i_px_for_x ), Px_index( i_px_for_y ) );
+            if( points.empty() or points.back().x != pt.x or points.back().y != pt.y ) { points.push_back( pt ); }
+        };
+
+        const Nat n = Nat( buckets.size() );
+        for( Nat i = 0; i < n; ++i ) {
+            const M4_bucket& b = buckets[i];
+            if( b.i_px_for_x < 0 ) {
+                if( i + 1 == n or buckets[i + 1].i_px_for_x >= 0 ) { add( b.i_px_for_x, b.last ); }
+                continue;
+            } else if( b.i_px_for_x >= i_px_beyond ) {
+                add( b.i_px_for_x, b.first );
+                break;
+            }
+            add( b.i_px_for_x, b.first );
+            add( b.i_px_for_x, b.min );
+            add( b.i_px_for_x, b.max );
+            add( b.i_px_for_x, b.last );
+        }
+        return points;
+    }
+
+    // The samples [i_first, i_beyond) with pixel index for x in [0, i_px_beyond), plus the one
+    // sample on each side. They’re found by binary search, so for a series in a memory-mapped file
+    // only the pages with the visible samples and a few more are read.
+    template< class Series >
+    auto visible_samples_of(
+        in_<Series>                             series,
+        in_<coordinate::Indices_transform>      transform,
+        const Nat                               i_px_beyond
+        ) -> std::pair<size_t, size_t>
+    {
+        const size_t n = series.size();
+        const auto i_first_with_index = [&]( const int i_px ) -> size_t {
+            size_t i_low = 0;  size_t i_high = n;
+            while( i_low < i_high ) {
+                const size_t i_middle = i_low + (i_high - i_low)/2;
+                if( int( transform.px_index_from_math_x( series.x( i_middle ) ) ) >= i_px ) {
+                    i_high = i_middle;
+                } else {
+                    i_low = i_middle + 1;
+                }
+            }
+            return i_low;
+        };
+        const size_t i_first_visible = i_first_with_index( 0 );
+        const size_t i_first_beyond = i_first_with_index( i_px_beyond );
+        return {(i_first_visible > 0? i_first_visible - 1 : 0), min( n, i_first_beyond + 1 )};
+    }
+
+    struct X_column{ enum Enum: int { none, interleaved }; };
+
+    // A series in a raw little-endian array of `Value`, i.e. `double` or `float`, in a memory
+    // mapped file or in memory. It’s either a sequence of records with x and y, or of only y with
+    // x given by the index, `x_first + i*x_step`. The mapping or array must outlive the series.
+    template< class Value, X_column::Enum x_column >
+    class Mapped_series_
+    {
+        static constexpr size_t record_size = (x_column == X_column::none? 1 : 2);
+
+        const Value*    m_values;
+        size_t          m_n;
+        double          m_x_first;
+        double          m_x_step;
+
+    public:
+        Mapped_series_( in_<files::Read_only_mapping> mapping, const double x_first = 0, const double x_step = 1 ):
+            m_values( static_cast<const Value*>( mapping.data() ) ),
+            m_n( mapping.size()/(record_size*sizeof( Value )) ),
+            m_x_first( x_first ),
+            m_x_step( x_step )
+        {}
+
+        Mapped_series_( const Value* const values, const size_t n, const double x_first = 0, const double x_step = 1 ):
+            m_values( values ),
+            m_n( n ),
+            m_x_first( x_first ),
+            m_x_step( x_step )
+        {}
+
+        auto size() const -> size_t { return m_n; }
+
+        auto x( const size_t i ) const
+            -> double
+        {
+            if constexpr( x_column == X_column::none ) {
+                return m_x_first + double( i )*m_x_step;
+            } else {
+                return m_values[record_size*i];
+            }
+        }
+
+        auto y( const size_t i ) const -> double { return m_values[record_size*i + record_size - 1]; }
+    };
+
+    // Plots a recorded series via M4 decimation, on `n_threads` threads. There are no markers.
+    template< class Series >
+    class Series_plotter_: public Function_plotter
+    {
+        Series      m_series;
+        Nat         m_n_threads;
+
+    public:
+        Series_plotter_( Series series, const Nat n_threads = 1 ):
+            m_series( move( series ) ),
+            m_n_threads( n_threads )
+        {}
+
+        void plot( graphics::Surface& surface, in_<Ct> transform ) const override
+        {
+            const auto i_px_beyond = int( transform.px_i_beyond<Ct::Math_axis::x>() );
+            const auto [i_first, i_beyond] = visible_samples_of( m_series, transform, i_px_beyond );
+            const vector<M4_bucket> buckets = m4_buckets_of( m_series, i_first, i_beyond, transform, m_n_threads );
+            const vector<POINT> points = m4_polyline_points( buckets, transform, i_px_beyond );
+            const SIZE size = transform.px_size();      // Only the visible parts, as for a function.
+            graphics::draw_clipped_polyline( surface, points.data(), Nat( points.size() ), RECT{ 0, 0, size.cx, size.cy } );
+        }
+
+        void add_markers( graphics::Surface&, in_<Ct> ) const override {}
+    };
+
+    // The minimum and maximum y of each aligned block of 2ᵏ samples of a series, for each level k
+    // from `base_level` until one block covers the series. This is a level-of-detail index that
+    // gives the M4 buckets with a number of block lookups per pixel index that doesn’t depend on
+    // the number of samples. With a base level of 6 the index is 1/16 of the size of a series of
+    // `double` y values.
+    //
+    // The data is an array of `double`: the number of samples, the base level, and then minimum
+    // and maximum pairs for each level in turn. So it can be saved next to the series as a raw
+    // array, and memory mapped. The data must outlive the view.
+    class Min_max_pyramid
+    {
+        const double*   m_data;
+        size_t          m_n_samples;
+        Nat             m_base_level;
+        vector<size_t>  m_level_starts;     // Indices of the first pairs, from the base level up.
+
+        static constexpr Nat header_size = 2;
+
+        static auto level_starts_for( const size_t n_samples, const Nat base_level )
+            -> vector<size_t>
+        {
+            vector<size_t> result;
+            size_t i_pair = 0;
+            for( Nat k = base_level; ; ++k ) {
+                result.push_back( i_pair );
+                const size_t n_blocks = ((n_samples + (size_t( 1 ) << k) - 1) >> k);
+                i_pair += n_blocks;
+                if( n_blocks <= 1 ) { break; }
+            }
+            result.push_back( i_pair );
+            return result;
+        }
+
+        auto pair_at( const Nat k, const size_t i_block ) const
+            -> const double*
+        { return m_data + header_size + 2*(m_level_starts[k - m_base_level] + i_block); }
+
+    public:
+        explicit Min_max_pyramid( const double* const data ):
+            m_data( data ),
+            m_n_samples( size_t( data[0] ) ),
+            m_base_level( Nat( data[1] ) ),
+            m_level_starts( level_starts_for( m_n_samples, m_base_level ) )
+        {}
+
+        auto n_samples() const -> size_t { return m_n_samples; }
+
+        template< class Series >
+        static auto data_for( in_<Series> series, const Nat base_level = 6 )
+            -> vector<double>
+        {
+            const size_t n = series.size();
+            const vector<size_t> level_starts = level_starts_for( n, base_level );
+            auto data = vector<double>( header_size + 2*level_starts.back() );
+            data[0] = double( n );
+            data[1] = base_level;
+
+            double* p_pair = data.data() + header_size;
+            const size_t block_size = size_t( 1 ) << base_level;
+            for( size_t i_first = 0; i_first < n; i_first += block_size ) {
+                double lo = series.y( i_first );  double hi = lo;
+                for( size_t i = i_first + 1; i < min( n, i_first + block_size ); ++i ) {
+                    const double y = series.y( i );
+                    lo = min( lo, y );  hi = max( hi, y );
+                }
+                *p_pair++ = lo;  *p_pair++ = hi;
+            }
+            for( Nat i_level = 1; i_level + 1 < Nat( level_starts.size() ); ++i_level ) {
+                const double* const p_below = data.data() + header_size + 2*level_starts[i_level - 1];
+                const size_t n_below = level_starts[i_level] - level_starts[i_level - 1];
+                for( size_t i = 0; i < n_below; i += 2 ) {
+                    const bool has_pair = (i + 1 < n_below);
+                    *p_pair++ = (has_pair? min( p_below[2*i], p_below[2*i + 2] ) : p_below[2*i]);
+                    *p_pair++ = (has_pair? max( p_below[2*i + 1], p_below[2*i + 3] ) : p_below[2*i + 1]);
+                }
+            }
+            return data;
+        }
+
+        // The minimum and maximum y of the samples [i_first, i_beyond) of `series`, which must be
+        // the indexed series. Samples that don’t fill a base level block are read directly.
+        template< class Series >
+        void get_min_max( in_<Series> series, size_t i_first, const size_t i_beyond, double& lo, double& hi ) const
+        {
+            const Nat top_level = m_base_level + Nat( m_level_starts.size() ) - 2;
+            const auto block_fits = [&]( const Nat k ) -> bool {
+                const size_t block_size = size_t( 1 ) << k;
+                return i_first % block_size == 0 and i_first + block_size <= i_beyond;
+            };
+
+            lo = series.y( i_first );  hi = lo;
+            while( i_first < i_beyond ) {
+                if( not block_fits( m_base_level ) ) {
+                    const double y = series.y( i_first );
+                    lo = min( lo, y );  hi = max( hi, y );
+                    ++i_first;
+                    continue;
+                }
+                Nat k = m_base_level;
+                while( k < top_level and block_fits( k + 1 ) ) { ++k; }
+                const double* const p_pair = pair_at( k, i_first >> k );
+                lo = min( lo, p_pair[0] );  hi = max( hi, p_pair[1] );
+                i_first += size_t( 1 ) << k;
+            }
+        }
+    };
+
+    // Plots a recorded series via M4 decimation with the buckets from a `Min_max_pyramid` of it,
+    // which gives the same points as `Series_plotter_`. Each bucket’s range of samples is found
+    // by an exponential search. There are no markers.
+    template< class Series >
+    class Lod_series_plotter_: public Function_plotter
+    {
+        Series              m_series;
+        Min_max_pyramid     m_pyramid;
+
+    public:
+        Lod_series_plotter_( Series series, in_<Min_max_pyramid> pyramid ):
+            m_series( move( series ) ),
+            m_pyramid( pyramid )
+        {
+            assert( m_pyramid.n_samples() == m_series.size() );
+        }
+
+        void plot( graphics::Surface& surface, in_<Ct> transform ) const override
+        {
+            const auto i_px_beyond = int( transform.px_i_beyond<Ct::Math_axis::x>() );
+            const auto [i_first, i_beyond] = visible_samples_of( m_series, transform, i_px_beyond );
+            const auto i_px_for_x = [&]( const size_t i ) -> int {
+                return int( transform.px_index_from_math_x( m_series.x( i ) ) );
+            };
+            const auto i_px_for_y = [&]( const double y ) -> int {
+                return int( transform.px_index_from_math_y( y ) );
+            };
+
+            vector<M4_bucket> buckets;
+            for( size_t i = i_first; i < i_beyond; ) {
+                const int i_px = i_px_for_x( i );
+
+                // The first sample beyond the bucket is in (i + step/2, i + step].
+                size_t step = 1;
+                while( i + step < i_beyond and i_px_for_x( i + step ) == i_px ) { step *= 2; }
+                size_t i_low = i + step/2 + 1;  size_t i_high = min( i + step, i_beyond );
+                while( i_low < i_high ) {
+                    const size_t i_middle = i_low + (i_high - i_low)/2;
+                    if( i_px_for_x( i_middle ) == i_px ) { i_low = i_middle + 1; } else { i_high = i_middle; }
+                }
+
+                double lo;  double hi;
+                m_pyramid.get_min_max( m_series, i, i_low, lo, hi );
+                buckets.push_back( {
+                    i_px, i_px_for_y( m_series.y( i ) ), i_px_for_y( lo ), i_px_for_y( hi ),
+                    i_px_for_y( m_series.y( i_low - 1 ) )
+                    } );
+                i = i_low;
+            }
+
+            const vector<POINT> points = m4_polyline_points( buckets, transform, i_px_beyond );
+            const SIZE size = transform.px_size();      // Only the visible parts, as for a function.
+            graphics::draw_clipped_polyline( surface, points.data(), Nat( points.size() ), RECT{ 0, 0, size.cx, size.cy } );
+        }
+
+        void add_markers( graphics::Surface&, in_<Ct> ) const override {}
+    };
+
+    class Painter
+    {
+        using Ct                = coordinate::Axis_relative_transform;      // Coordinate Transform
+        using Px_point          = coordinate::Px_point;
+        using Px_point_vector   = coordinate::Px_point_vector;
+        using Px_index          = coordinate::Px_index;
+
+        graphics::Surface&          m_surface;
+        const Ct                    m_transform;
+        const Function_plotter&     m_plotter;
+
+        template< Ct::Math_axis::Enum axis >
+        inline void draw_math_axis( graphics::Surface& surface ) const;
+
+        template< Ct::Math_axis::Enum axis >
+        inline void add_math_axis_ticks( graphics::Surface& surface, const Nat tick_distance ) const;
+
+        void draw_axes_with_ticks( graphics::Surface& surface ) const
+        {
+            // The axis loops are unrolled at compile time, so the transforms have no axis branches.
+            Ct::for_each_math_axis( [&]( const auto axis ) {
+                draw_math_axis<decltype( axis )::value>( surface );
+            } );
+            Ct::for_each_math_axis( [&]( const auto axis ) {
+                add_math_axis_ticks<decltype( axis )::value>( surface, 5 );
+            } );
+        }
+
+    public:
+        Painter(
+            graphics::Surface&          surface,
+            in_<SIZE>                   client_area_size,
+            const Function_plotter&     plotter             = the_parabola_plotter
+            ):
+            m_surface( surface ),
+            m_transform( client_area_size ),
+            m_plotter( plotter )
+        {}
+
+        void paint() const
+        {
+            // With a surface that offers a batch the primitives are collected by kind, and drawn
+            // with one surface call per kind: the axes, ticks and graph as one multi-polyline, and
+            // the markers as one rectangle list.
+            graphics::Primitive_batch* const p_batch = m_surface.batch();
+            if( p_batch ) { p_batch->clear(); }
+            graphics::Surface& surface = (p_batch? *p_batch : m_surface);
+
+            // Display the math x and y axes first to make the graph appear to be “above”.
+            draw_axes_with_ticks( surface );
+            m_plotter.plot( surface, m_transform );
+            m_plotter.add_markers( surface, m_transform );
+            if( p_batch ) { p_batch->submit_to( m_surface ); }
+        }
+    };
+
+    template< Painter::Ct::Math_axis::Enum axis >
+    void Painter::draw_math_axis( graphics::Surface& surface ) const
+    {
+        const auto& _ = m_transform;
+        const double    first_v     = _.math_minimum<axis>();
+        const double    last_v      = _.math_maximum<axis>();
+        graphics::draw_line( surface, _.px_pt_from<axis>( first_v ), _.px_pt_from<axis>( last_v ) );
+    }
+
+    template< Painter::Ct::Math_axis::Enum axis >
+    void Painter::add_math_axis_ticks( graphics::Surface& surface, const Nat tick_distance ) const
+    {
+        const auto& _ = m_transform;
+        const Px_point_vector   tick_extent     = 2*rotl( _.px_unit_vector_for<axis>() );
+        const Nat               td              = tick_distance;
+
+        const double    min_marker_value    = td*trunc( _.math_minimum<axis>()/td );
+        const double    max_marker_value    = td*trunc( _.math_maximum<axis>()/td );
+
+        // Add ticks on the math axis for every td math units. Note: looping over integer values.
+        for( double value = min_marker_value; value <= max_marker_value; value += td ) {
+            const Px_point pt = _.px_pt_from<axis>( value );
+            graphics::draw_line( surface, pt - tick_extent, pt + tick_extent );
+        }
+    }
+
+    // The portable window behavior, with a handler for each kind of event. `Platform` provides
+    // the `Backbuffer` type for a retained frame, plus `paint_target()`, `invalidate_all()` and
+    // `quit( exit_code )`.
+    //
+    // Size events only record the size and invalidate, so a storm of them during a live resize
+    // costs one render per paint, of the latest size.
+    template< class Platform >
+    class Main_window_
+    {
+        using Event = events::Event;
+
+        Platform&                                                       m_platform;
+        graphics::Retained_frame_<typename Platform::Backbuffer>        m_frame;
+        SIZE                                                            m_client_area_size  = {0, 0};
+
+    public:
+        template< class... Backbuffer_args >
+        Main_window_( Platform& platform, Backbuffer_args&&... backbuffer_args ):
+            m_platform( platform ),
+            m_frame( std::forward<Backbuffer_args>( backbuffer_args )... )
+        {}
+
+        auto n_renders() const -> Nat { return m_frame.n_renders(); }
+
+        void on_destroy()
+        {
+            // The window is being destroyed. Terminate the event loop to avoid a hang:
+            m_platform.quit( Process_exit_code::success );
+        }
+
+        void on_paint( in_<RECT> update_rect )
+        {
+            m_frame.paint( m_platform.paint_target(), m_client_area_size, update_rect,
+                []( graphics::Surface& surface, in_<SIZE> size ) { Painter( surface, size ).paint(); }
+                );
+        }
+
+        void on_size( in_<SIZE> new_size )
+        {
+            m_client_area_size = new_size;
+            m_platform.invalidate_all();
+        }
+
+        void handle( in_<Event> e )
+        {
+            switch( e.kind ) {
+                case Event::Kind::destroy:  { on_destroy();  return; }
+                case Event::Kind::paint:    { on_paint( e.update_rect );  return; }
+                case Event::Kind::size:     { on_size( e.size );  return; }
+            }
+        }
+    };
+
+#ifdef _WIN32
+    struct Winapi_platform
+    {
+        using Backbuffer = winapi::Bitmap_backbuffer;
+
+        HWND    window              = HWND();
+        HDC     dc_being_painted    = HDC();
+
+        auto paint_target() const -> HDC { return dc_being_painted; }
+
+        // `false` ⇨ no erasing, the copy from the retained frame covers all.
+        void invalidate_all() { InvalidateRect( window, nullptr, false ); }
+
+        void quit( const Process_exit_code code ) { PostQuitMessage( code ); }
+    };
+
+    // There’s only one window. Its GDI objects are created by `run`, not during static
+    // initialization, so `p_the_main_window` is set there.
+    Winapi_platform                     the_platform;
+    Main_window_<Winapi_platform>*      p_the_main_window   = nullptr;
+
+    // The message handlers translate messages to portable events.
+
+    void on_wm_destroy( const HWND window )
+    {
+        (void) window;      // Unused.
+        p_the_main_window->handle( {events::Event::Kind::destroy, {}, {}} );
+    }
+
+    void on_wm_paint( const HWND window )
+    {
+        PAINTSTRUCT     info = {};          // Primarily a dc and an update rectangle.
+
+        const HDC dc = BeginPaint( window, &info );
+        if( dc ) {
+            the_platform.dc_being_painted = dc;
+            p_the_main_window->handle( {events::Event::Kind::paint, {}, info.rcPaint} );
+            the_platform.dc_being_painted = HDC();
+        }
+        EndPaint( window, &info );
+    }
+
+    void on_wm_size( const HWND window, const LPARAM ell_param )
+    {
+        the_platform.window = window;
+        const SIZE new_size = {LOWORD( ell_param ), HIWORD( ell_param )};
+        p_the_main_window->handle( {events::Event::Kind::size, new_size, {}} );
+    }
+
+    auto CALLBACK window_proc(
+        const HWND          window,
+        const UINT          msg_id,         // Can be e.g. `WM_COMMAND`, `WM_SIZE`, ...
+        const WPARAM        w_param,        // Meaning depends on the `msg_id`.
+        const LPARAM        ell_param       // Meaning depends on the `msg_id`.
+        ) -> LRESULT
+    {
+        switch( msg_id ) {
+            case WM_DESTROY:    { on_wm_destroy( window );  return 0; }
+            case WM_PAINT:      { on_wm_paint( window );  return 0; }
+            case WM_SIZE:       { on_wm_size( window, ell_param );  return 0; }
+            case WM_ERASEBKGND: { return 1; }       // Erased, in the sense that painting covers all.
+        }
+        return DefWindowProc( window, msg_id, w_param, ell_param );     // Default handling.
+    }
+
+    auto make_window_class_params( const HBRUSH background )
+        -> WNDCLASS
+    {
+        WNDCLASS params = {};
+        params.lpfnWndProc      = &window_proc;
+        params.hInstance        = GetModuleHandle( 0 );         // Not very useful in modern code.
+        params.hIcon            = LoadIcon( 0, IDI_APPLICATION );
+        params.hCursor          = LoadCursor( 0, IDC_ARROW );
+        params.hbrBackground    = background;
+        params.lpszClassName    = window_class_name;
+        return params;
+    };
+
+    auto run()
+        -> Process_exit_code
+    {
+        const HBRUSH orange_brush = CreateSolidBrush( RGB( 0xFF, 0x80, 0x00 ) );
+        auto main_window = Main_window_<Winapi_platform>( the_platform, orange_brush );
+        p_the_main_window = &main_window;       // Before `CreateWindow`, which sends `WM_SIZE`.
+
+        const WNDCLASS window_class_params = make_window_class_params( orange_brush );
+        RegisterClass( &window_class_params );
+
+        const HWND window = CreateWindow(
+            window_class_name,
+            window_title,
+            WS_OVERLAPPEDWINDOW,                        // Resizable and has a title bar.
+            CW_USEDEFAULT, CW_USEDEFAULT, 640, 400,     // x y w h
+            HWND(),                                     // Owner window; none.
+            HMENU(),                                    // Menu handle or child window id.
+            GetModuleHandle( 0 ),                       // Not very useful in modern code.
+            nullptr                                     // Custom parameter for app’s use.
+            );
+        if( not window ) {
+            return Process_exit_code::failure;          // Avoid hanging in the event loop.
+        }
+
+        ShowWindow( window, SW_SHOWDEFAULT );           // Displays the window.
+
+        // Event loop a.k.a. message loop:
+        for( ;; ) {
+            MSG msg;
+            switch( sign_of( GetMessage( &msg, 0, 0, 0 ) ) ) {
+                case +1: {
+                    TranslateMessage( &msg );           // Provides e.g. Alt+Space sysmenu shortcut.
+                    DispatchMessage( &msg );            // Calls the window proc of relevant window.
+                    continue;
+                }
+                case 0: {
+                    assert( msg.message == WM_QUIT );
+                    return Process_exit_code( msg.wParam );
+                }
+                case -1: {
+                    return Process_exit_code::failure;
+                }
+            }
+        }
+    }
+#endif
+}  // app
+
+#ifdef _WIN32
+auto main() -> int { return app::run(); }
+#endif
@@ -0,0 +1,33 @@
+﻿#pragma once
+// Time measurement for the checks of the parabola programs.
+#include <chrono>
+
+namespace timing {
+    namespace chrono = std::chrono;
+
+    // The time of one call of `f`.
+    template< class Func >
+    auto seconds_for( Func&& f )
+        -> double
+    {
+        const auto start_time = chrono::steady_clock::now();
+        f();
+        return chrono::duration<double>( chrono::steady_clock::now() - start_time ).count();
+    }
+
+    // The average time of calls of `f`, repeated for at least half a second.
+    template< class Func >
+    auto seconds_per_call_of( Func&& f )
+        -> double
+    {
+        const auto  start_time  = chrono::steady_clock::now();
+        int         n_calls     = 0;
+        double      n_seconds   = 0;
+        do {
+            f();
+            ++n_calls;
+            n_seconds = chrono::duration<double>( chrono::steady_clock::now() - start_time ).count();
+        } while( n_seconds < 0.5 );
+        return n_seconds/n_calls;
+    }
+}  // timing